@@ -1,398 +1,447 @@
 // ReservaHotelGTK.c
+// Interface gráfica do sistema de reservas; as reservas ficam no motor de
+// reservas (motor_reservas.h)
 #include <gtk/gtk.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <locale.h>
-
-// Definições e Estruturas
-#define QUARTOS_DISPONIVEIS 50
-#define CAPACIDADE_TOTAL 100
-#define PRECO_RESERVA 250.0 // Preço por pessoa por diária
-
-typedef struct {
-    int reserva_id;        // ID único da reserva
-    int quarto_id;         // ID do quarto
-    char nome_cliente[100];
-    char data_inicio[11];  // Formato DD/MM/AAAA
-    int num_diarias;
-    int num_pessoas;
-    float preco;
-} Reserva;
-
-typedef struct No {
-    Reserva reserva;
-    struct No* prox;
-    struct No* ant;
-} No;
+#include "motor_reservas.h"
+#include "analise_reservas.h"
 
 // Definição da Estrutura AppWidgets
 typedef struct {
     GtkWidget *window;
     GtkWidget *treeview;
+    GtkWidget *painel;  // Ocupação de hoje
 } AppWidgets;
 
 // Protótipos das Funções
-No* inicializarLista();
-int verificarDataValida(const char* data_str);
-int isAnoBissexto(int ano);
-int diasNoMes(int mes, int ano);
-struct tm parse_date(const char* date_str);
-struct tm add_days(struct tm date, int days);
-int compare_dates(struct tm date1, struct tm date2);
-int ranges_overlap(struct tm start1, int days1, struct tm start2, int days2);
-int compare_reserva_dates(Reserva a, Reserva b);
-No* split_list(No* head);
-No* sorted_merge(No* first, No* second);
-No* merge_sort(No* head);
-int isRoomAvailable(No* lista, int room, struct tm new_start, int new_days);
-No* inserirReserva(No* lista, Reserva nova_reserva);
-No* removerReserva(No* lista, int id);
-Reserva* buscarReserva(No* lista, int id);
-int contarTotalPessoas(No* lista);
-void adicionarReservasIniciais(No* lista);
+int executarLinhaComando(const char* comando, const char* argumento);
+long imprimirRelatorio(int ano);
+int adicionarReservasIniciais();
 void atualizarTreeView(AppWidgets *widgets);
+void atualizarPainel(AppWidgets *widgets);
 void on_insert_reserva(GtkWidget *widget, gpointer data);
 void on_remove_reserva(GtkWidget *widget, gpointer data);
 void on_search_reserva(GtkWidget *widget, gpointer data);
 void on_display_reservas(GtkWidget *widget, gpointer data);
+gboolean sincronizar_diario_periodico(gpointer data);
+void formatar_preco(double preco, char* preco_str, size_t tamanho);
 GtkWidget* criar_tree_view();
 void aplicar_css(GtkWidget *widget, const char *arquivo_css);
 
 // Variáveis Globais
-No* lista_reservas = NULL;
-int current_id = 1;
+MotorReservas* motor = NULL;  // Reservas do hotel
 
 // Implementação das Funções
 
-No* inicializarLista() {
-    return NULL;
+// Função para imprimir o relatório mensal de receita e ocupação de um ano.
+// Retorna quantas reservas entraram no ano ou -1 se o ano for inválido.
+long imprimirRelatorio(int ano) {
+    if (ano < 1900 || ano > 9999) {
+        printf("Ano inválido.\n");
+        return -1;
+    }
+    DataCompacta de = data_para_dias(1, 1, ano);
+    DataCompacta ate = data_para_dias(1, 1, ano + 1);
+    ResumoMes meses[12];
+    resumirPorMes(motor, de, ate, meses, 12);
+    TotaisReservas total = totalizarReservas(motor, de, ate);
+
+    printf("Relatório de %d (somas: %s)\n\n", ano, nucleoAnalise());
+    printf("%-9s %9s %10s %15s %10s %10s %11s\n", "Mês", "Reservas", "Diárias", "Receita", "ADR", "RevPAR", "Ocupação");
+    for (int i = 0; i < 12; i++) {
+        printf("%02d/%04d  %9ld %9ld %15.2f %10.2f %10.2f %8.1f%%\n", meses[i].mes, meses[i].ano,
+               meses[i].totais.reservas, meses[i].totais.diarias, meses[i].totais.receita,
+               meses[i].adr, meses[i].revpar, meses[i].ocupacao * 100.0);
+    }
+    double disponiveis = (double) contarQuartos(motor) * (ate - de);
+    printf("%-8s %9ld %9ld %15.2f %10.2f %10.2f %8.1f%%\n", "Total", total.reservas, total.diarias, total.receita,
+           total.diarias > 0 ? total.receita / total.diarias : 0.0, total.receita / disponiveis,
+           total.diarias / disponiveis * 100.0);
+    printf("\nCada reserva conta inteira no mês da data de entrada.\n");
+    return total.reservas;
 }
 
-int isAnoBissexto(int ano) {
-    return (ano % 4 == 0 && ano % 100 != 0) || (ano % 400 == 0);
-}
+// Função para executar a importação (--importar), a exportação (--exportar)
+// ou o relatório anual (--relatorio) sem abrir a interface gráfica.
+// Retorna o código de saída do programa.
+int executarLinhaComando(const char* comando, const char* argumento) {
+    if (carregarReservas(motor, ARQUIVO_RESERVAS) < 0) {
+        printf("O arquivo %s está corrompido.\n", ARQUIVO_RESERVAS);
+        return 1;
+    }
+    if (diario_reproduzir(motor, ARQUIVO_DIARIO) < 0 || !diario_abrir(motor, ARQUIVO_DIARIO, ARQUIVO_RESERVAS, DIARIO_JANELA_MS)) {
+        printf("Não foi possível abrir o diário %s.\n", ARQUIVO_DIARIO);
+        return 1;
+    }
 
-int diasNoMes(int mes, int ano) {
-    switch (mes) {
-        case 1: case 3: case 5: case 7: case 8: case 10: case 12: return 31;
-        case 4: case 6: case 9: case 11: return 30;
-        case 2: return isAnoBissexto(ano) ? 29 : 28;
-        default: return 0; // Mês inválido
+    long total;
+    if (strcmp(comando, "--importar") == 0) {
+        total = importarReservasCSV(motor, argumento);
+        if (total >= 0) {
+            printf("%ld reserva(s) importada(s) de %s.\n", total, argumento);
+        } else {
+            printf("Nenhuma reserva foi importada.\n");
+        }
+    } else if (strcmp(comando, "--relatorio") == 0) {
+        total = imprimirRelatorio(atoi(argumento));
+    } else {
+        total = exportarReservasCSV(motor, argumento);
+        if (total >= 0) {
+            printf("%ld reserva(s) exportada(s) para %s.\n", total, argumento);
+        }
     }
-}
 
-// Função para parsear uma string de data no formato "DD/MM/AAAA" para struct tm
-struct tm parse_date(const char* date_str) {
-    struct tm date = {0};
-    sscanf(date_str, "%d/%d/%d", &date.tm_mday, &date.tm_mon, &date.tm_year);
-    date.tm_mon -= 1; // tm_mon é 0-based
-    date.tm_year -= 1900; // tm_year é anos desde 1900
-    return date;
+    diario_compactar(motor);
+    liberarMotorReservas(motor);
+    return total >= 0 ? 0 : 1;
 }
 
-// Função para adicionar dias a uma struct tm
-struct tm add_days(struct tm date, int days) {
-    date.tm_mday += days;
-    mktime(&date); // Normaliza a data
-    return date;
+// Função para adicionar as reservas de exemplo da primeira execução, nos
+// quartos 5 a 25 do layout padrão. As que o motor recusar são informadas.
+// Retorna quantas foram incluídas.
+int adicionarReservasIniciais() {
+    Reserva iniciais[] = {
+        {0, 5, "Alice Santos", "15/11/2024", 3, 2, 0.0},
+        {0, 10, "Bruno Lima", "20/12/2024", 2, 4, 0.0},
+        {0, 15, "Carla Oliveira", "05/01/2025", 5, 3, 0.0},
+        {0, 20, "Daniel Costa", "25/12/2024", 1, 1, 0.0},
+        {0, 25, "Eliana Martins", "10/11/2024", 2, 4, 0.0},
+    };
+
+    int incluidas = 0;
+    for (size_t i = 0; i < sizeof(iniciais) / sizeof(iniciais[0]); i++) {
+        if (inserirReserva(motor, &iniciais[i]) != 0) {
+            incluidas++;
+        } else {
+            printf("Reserva inicial de %s (quarto %d) não incluída.\n", iniciais[i].nome_cliente,
+                   iniciais[i].quarto_id);
+        }
+    }
+    return incluidas;
 }
 
-// Função para comparar duas datas. Retorna 1 se date1 <= date2, 0 caso contrário
-int compare_dates(struct tm date1, struct tm date2) {
-    time_t t1 = mktime(&date1);
-    time_t t2 = mktime(&date2);
-    return difftime(t1, t2) <= 0;
+// Função para formatar o preço com duas casas decimais e vírgula
+void formatar_preco(double preco, char* preco_str, size_t tamanho) {
+    snprintf(preco_str, tamanho, "R$%.2f", preco);
+    // Substitui ponto por vírgula
+    for(int i = 0; preco_str[i] != '\0'; i++) {
+        if(preco_str[i] == '.') {
+            preco_str[i] = ',';
+            break;
+        }
+    }
 }
 
-// Função para verificar se dois períodos de reserva se sobrepõem
-int ranges_overlap(struct tm start1, int days1, struct tm start2, int days2) {
-    struct tm end1 = add_days(start1, days1 - 1);
-    struct tm end2 = add_days(start2, days2 - 1);
-    
-    // Períodos se sobrepõem se start1 <= end2 e start2 <= end1
-    return (compare_dates(start1, end2) && compare_dates(start2, end1));
+// Modelo da TreeView: em vez de copiar cada reserva para um GtkListStore, a
+// TreeView lê as linhas diretamente da lista de reservas. Cada GtkTreeIter
+// aponta para o nó da reserva, e os textos só são formatados quando a
+// TreeView pede uma célula (isto é, para as linhas visíveis).
+enum {
+    COLUNA_ID,
+    COLUNA_QUARTO,
+    COLUNA_CLIENTE,
+    COLUNA_DATA,
+    COLUNA_PESSOAS,
+    COLUNA_DIARIAS,
+    COLUNA_PRECO,
+    NUM_COLUNAS
+};
+
+#define MODELO_TIPO_RESERVAS (modelo_reservas_get_type())
+G_DECLARE_FINAL_TYPE(ModeloReservas, modelo_reservas, MODELO, RESERVAS, GObject)
+
+struct _ModeloReservas {
+    GObject parent_instance;
+    gint stamp;   // Identifica iters emitidos por este modelo
+    gint linhas;  // Linhas já anunciadas à TreeView (ver modelo_reservas_notificar)
+};
+
+static void modelo_reservas_tree_model_init(GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(ModeloReservas, modelo_reservas, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, modelo_reservas_tree_model_init))
+
+static void modelo_reservas_init(ModeloReservas *modelo) {
+    modelo->stamp = g_random_int();
 }
 
-int verificarDataValida(const char* data_str) {
-    int dia, mes, ano;
-    sscanf(data_str, "%d/%d/%d", &dia, &mes, &ano);
-
-    if (ano < 1900 || ano > 2100) return 0;
-    if (mes < 1 || mes > 12) return 0;
-    if (dia < 1 || dia > diasNoMes(mes, ano)) return 0;
-
-    time_t agora = time(NULL);
-    struct tm* hoje_tm = localtime(&agora);
-
-    int dia_hoje = hoje_tm->tm_mday;
-    int mes_hoje = hoje_tm->tm_mon + 1;  // Meses vão de 0 a 11
-    int ano_hoje = hoje_tm->tm_year + 1900;
-
-    if (ano < ano_hoje) return 0;
-    if (ano == ano_hoje) {
-        if (mes < mes_hoje) return 0;
-        if (mes == mes_hoje && dia < dia_hoje) return 0;
-    }
-
-    return 1;
+static void modelo_reservas_class_init(ModeloReservasClass *klass) {
 }
 
-int compare_reserva_dates(Reserva a, Reserva b) {
-    struct tm date_a = parse_date(a.data_inicio);
-    struct tm date_b = parse_date(b.data_inicio);
-    
-    time_t t_a = mktime(&date_a);
-    time_t t_b = mktime(&date_b);
-    
-    double diff = difftime(t_a, t_b);
-    
-    if (diff < 0)
-        return -1;
-    else if (diff > 0)
-        return 1;
-    else
-        return 0;
-}
-
-// Função para dividir a lista em duas metades
-No* split_list(No* head) {
-    No* slow = head;
-    No* fast = head;
-    
-    while (fast->prox && fast->prox->prox) {
-        slow = slow->prox;
-        fast = fast->prox->prox;
-    }
-    
-    No* mid = slow->prox;
-    slow->prox = NULL;
-    if (mid)
-        mid->ant = NULL;
-    
-    return mid;
-}
-
-// Função para mesclar duas listas ordenadas
-No* sorted_merge(No* first, No* second) {
-    if (!first)
-        return second;
-    if (!second)
-        return first;
-    
-    // Comparar as datas das reservas
-    if (compare_reserva_dates(first->reserva, second->reserva) <= 0) {
-        first->prox = sorted_merge(first->prox, second);
-        if (first->prox)
-            first->prox->ant = first;
-        first->ant = NULL;
-        return first;
-    } else {
-        second->prox = sorted_merge(first, second->prox);
-        if (second->prox)
-            second->prox->ant = second;
-        second->ant = NULL;
-        return second;
+// Função para preencher um iter a partir de um nó; retorna FALSE se não há nó
+static gboolean modelo_reservas_preencher_iter(ModeloReservas *modelo, GtkTreeIter *iter, No *no) {
+    if (no == NULL) {
+        iter->stamp = 0;
+        return FALSE;
     }
+    iter->stamp = modelo->stamp;
+    iter->user_data = no;
+    iter->user_data2 = NULL;
+    iter->user_data3 = NULL;
+    return TRUE;
 }
 
-// Função recursiva Merge Sort
-No* merge_sort(No* head) {
-    if (!head || !head->prox)
-        return head;
-    
-    // Dividir a lista em duas metades
-    No* second = split_list(head);
-    
-    // Ordenar recursivamente cada metade
-    head = merge_sort(head);
-    second = merge_sort(second);
-    
-    // Mesclar as duas metades ordenadas
-    return sorted_merge(head, second);
-}
-
-int isRoomAvailable(No* lista, int room, struct tm new_start, int new_days) {
-    No* temp = lista;
-    while(temp != NULL) {
-        if(temp->reserva.quarto_id == room) {
-            struct tm existing_start = parse_date(temp->reserva.data_inicio);
-            int existing_days = temp->reserva.num_diarias;
-            if(ranges_overlap(existing_start, existing_days, new_start, new_days)) {
-                return 0; // Não disponível
-            }
-        }
-        temp = temp->prox;
-    }
-    return 1; // Disponível
+static GtkTreeModelFlags modelo_reservas_get_flags(GtkTreeModel *tree_model) {
+    // Os nós não mudam de endereço enquanto a reserva existir
+    return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
 }
 
-No* inserirReserva(No* lista, Reserva nova_reserva) {
-    // Calcula o preço total
-    nova_reserva.preco = PRECO_RESERVA * nova_reserva.num_pessoas * nova_reserva.num_diarias;
-    nova_reserva.reserva_id = current_id++;
+static gint modelo_reservas_get_n_columns(GtkTreeModel *tree_model) {
+    return NUM_COLUNAS;
+}
 
-    No* novo_no = (No*) malloc(sizeof(No));
-    if (novo_no == NULL) {
-        printf("Erro de alocação de memória!\n");
-        exit(1);
+static GType modelo_reservas_get_column_type(GtkTreeModel *tree_model, gint index) {
+    switch (index) {
+        case COLUNA_CLIENTE:
+        case COLUNA_DATA:
+        case COLUNA_PRECO:
+            return G_TYPE_STRING;
+        case COLUNA_ID:
+        case COLUNA_QUARTO:
+        case COLUNA_PESSOAS:
+        case COLUNA_DIARIAS:
+            return G_TYPE_INT;
+        default:
+            return G_TYPE_INVALID;
     }
-    novo_no->reserva = nova_reserva;
-    novo_no->prox = NULL;
-    novo_no->ant = NULL;
+}
 
-    if (lista == NULL) {  
-        return novo_no;
-    } else {
-        No* temp_insert = lista;
-        while (temp_insert->prox != NULL) {
-            temp_insert = temp_insert->prox;
-        }
-        temp_insert->prox = novo_no;
-        novo_no->ant = temp_insert;
-        return lista;
+static gboolean modelo_reservas_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    if (gtk_tree_path_get_depth(path) != 1) {
+        iter->stamp = 0;
+        return FALSE;
     }
+    int indice = gtk_tree_path_get_indices(path)[0];
+    return modelo_reservas_preencher_iter(modelo, iter, noNaPosicao(motor, indice));
 }
 
-No* removerReserva(No* lista, int id) {
-    if (lista == NULL) {
-        return NULL;
-    }
+static GtkTreePath* modelo_reservas_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    g_return_val_if_fail(iter->stamp == modelo->stamp, NULL);
+    return gtk_tree_path_new_from_indices(posicaoDoNo(motor, (No*) iter->user_data), -1);
+}
 
-    No* temp = lista;
-    while (temp != NULL && temp->reserva.reserva_id != id) {
-        temp = temp->prox;
+static void modelo_reservas_get_value(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    g_return_if_fail(iter->stamp == modelo->stamp);
+    const Reserva *reserva = reservaDoNo((No*) iter->user_data);
+
+    g_value_init(value, modelo_reservas_get_column_type(tree_model, column));
+    switch (column) {
+        case COLUNA_ID:       g_value_set_int(value, reserva->reserva_id); break;
+        case COLUNA_QUARTO:   g_value_set_int(value, reserva->quarto_id); break;
+        case COLUNA_CLIENTE:  g_value_set_string(value, reserva->nome_cliente); break;
+        case COLUNA_DATA:     g_value_set_string(value, reserva->data_inicio); break;
+        case COLUNA_PESSOAS:  g_value_set_int(value, reserva->num_pessoas); break;
+        case COLUNA_DIARIAS:  g_value_set_int(value, reserva->num_diarias); break;
+        case COLUNA_PRECO: {
+            char preco_str[20];
+            formatar_preco(reserva->preco, preco_str, sizeof(preco_str));
+            g_value_set_string(value, preco_str);
+            break;
+        }
     }
+}
 
-    if (temp == NULL) {
-        return lista;
-    } else {
-        if (temp->ant != NULL) {
-            temp->ant->prox = temp->prox;
-        } else {
-            lista = temp->prox;
-        }
+static gboolean modelo_reservas_iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    g_return_val_if_fail(iter->stamp == modelo->stamp, FALSE);
+    return modelo_reservas_preencher_iter(modelo, iter, proximoNo((No*) iter->user_data));
+}
 
-        if (temp->prox != NULL) {
-            temp->prox->ant = temp->ant;
-        }
+static gboolean modelo_reservas_iter_previous(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    g_return_val_if_fail(iter->stamp == modelo->stamp, FALSE);
+    return modelo_reservas_preencher_iter(modelo, iter, noAnterior((No*) iter->user_data));
+}
 
-        free(temp);
-        return lista;
+static gboolean modelo_reservas_iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    if (parent != NULL) {
+        iter->stamp = 0;
+        return FALSE;
     }
+    return modelo_reservas_preencher_iter(modelo, iter, primeiroNo(motor));
 }
 
-Reserva* buscarReserva(No* lista, int id) {
-    No* temp = lista;
-    while (temp != NULL && temp->reserva.reserva_id != id) {
-        temp = temp->prox;
-    }
+static gboolean modelo_reservas_iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return FALSE;
+}
 
-    if (temp == NULL) {
-        return NULL;
-    } else {
-        return &temp->reserva;
-    }
+static gint modelo_reservas_iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return iter == NULL ? MODELO_RESERVAS(tree_model)->linhas : 0;
 }
 
-int contarTotalPessoas(No* lista) {
-    int totalPessoas = 0;
-    No* temp = lista;
-    while (temp != NULL) {
-        totalPessoas += temp->reserva.num_pessoas;
-        temp = temp->prox;
+static gboolean modelo_reservas_iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent, gint n) {
+    ModeloReservas *modelo = MODELO_RESERVAS(tree_model);
+    if (parent != NULL) {
+        iter->stamp = 0;
+        return FALSE;
     }
-    return totalPessoas;
+    return modelo_reservas_preencher_iter(modelo, iter, noNaPosicao(motor, n));
 }
 
-void adicionarReservasIniciais(No* lista) {
-    Reserva r1 = {0, 5, "Alice Santos", "15/11/2024", 3, 2, 0.0};
-    Reserva r2 = {0, 10, "Bruno Lima", "20/12/2024", 2, 4, 0.0};
-    Reserva r3 = {0, 15, "Carla Oliveira", "05/01/2025", 5, 3, 0.0};
-    Reserva r4 = {0, 20, "Daniel Costa", "25/12/2024", 1, 1, 0.0};
-    Reserva r5 = {0, 25, "Eliana Martins", "10/11/2024", 2, 4, 0.0};
+static gboolean modelo_reservas_iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child) {
+    iter->stamp = 0;
+    return FALSE;
+}
 
-    lista = inserirReserva(lista, r1);
-    lista = inserirReserva(lista, r2);
-    lista = inserirReserva(lista, r3);
-    lista = inserirReserva(lista, r4);
-    lista = inserirReserva(lista, r5);
+static void modelo_reservas_tree_model_init(GtkTreeModelIface *iface) {
+    iface->get_flags = modelo_reservas_get_flags;
+    iface->get_n_columns = modelo_reservas_get_n_columns;
+    iface->get_column_type = modelo_reservas_get_column_type;
+    iface->get_iter = modelo_reservas_get_iter;
+    iface->get_path = modelo_reservas_get_path;
+    iface->get_value = modelo_reservas_get_value;
+    iface->iter_next = modelo_reservas_iter_next;
+    iface->iter_previous = modelo_reservas_iter_previous;
+    iface->iter_children = modelo_reservas_iter_children;
+    iface->iter_has_child = modelo_reservas_iter_has_child;
+    iface->iter_n_children = modelo_reservas_iter_n_children;
+    iface->iter_nth_child = modelo_reservas_iter_nth_child;
+    iface->iter_parent = modelo_reservas_iter_parent;
+}
 
-    lista_reservas = lista;
+// Função para repassar à TreeView uma mudança na lista como um sinal de
+// linha inserida ou removida, sem reconstruir o resto da visualização.
+// O motor chama o observador com a trava de escrita tomada e a TreeView
+// consulta o modelo dentro dos sinais, então nenhuma função do modelo pode
+// tomar a trava: a quantidade de linhas é contada aqui, e não com
+// contarReservas.
+static void modelo_reservas_notificar(TipoEvento tipo, No *no, int posicao, void *dados) {
+    ModeloReservas *modelo = MODELO_RESERVAS(dados);
+    GtkTreePath *path = gtk_tree_path_new_from_indices(posicao, -1);
+    if (tipo == EVENTO_INSERCAO) {
+        GtkTreeIter iter;
+        modelo->linhas++;
+        modelo_reservas_preencher_iter(modelo, &iter, no);
+        gtk_tree_model_row_inserted(GTK_TREE_MODEL(modelo), path, &iter);
+    } else {
+        modelo->linhas--;
+        gtk_tree_model_row_deleted(GTK_TREE_MODEL(modelo), path);
+    }
+    gtk_tree_path_free(path);
 }
 
 // Função para Configurar a TreeView
 GtkWidget* criar_tree_view() {
-    GtkListStore *store;
     GtkTreeViewColumn *col;
     GtkCellRenderer *renderer;
 
-    // Cria a lista (modelo) com os tipos de dados
-    // Alterado o último tipo para G_TYPE_STRING para exibir preço formatado
-    store = gtk_list_store_new(7, G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT, G_TYPE_INT, G_TYPE_STRING);
+    // Cria o modelo ligado diretamente à lista de reservas
+    ModeloReservas *modelo = g_object_new(MODELO_TIPO_RESERVAS, NULL);
+    modelo->linhas = contarReservas(motor);
 
-    // Cria a TreeView e associa o modelo
-    GtkWidget *treeview = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
-    g_object_unref(store);
+    // Cria a TreeView e associa o modelo, que passa a receber as mudanças da lista
+    GtkWidget *treeview = gtk_tree_view_new_with_model(GTK_TREE_MODEL(modelo));
+    definirObservadorReservas(motor, modelo_reservas_notificar, modelo);
+    g_object_unref(modelo);
 
-    // Define os títulos das colunas
+    // Define os títulos das colunas. Com larguras fixas a TreeView não precisa
+    // medir todas as linhas, apenas as visíveis.
     const char *titles[] = {"ID", "Quarto", "Cliente", "Data de Início", "Pessoas", "Diárias", "Preço (R$)"};
-    for(int i = 0; i < 7; i++) {
+    const int larguras[] = {60, 70, 240, 120, 80, 80, 120};
+    for(int i = 0; i < NUM_COLUNAS; i++) {
         renderer = gtk_cell_renderer_text_new();
         col = gtk_tree_view_column_new_with_attributes(titles[i], renderer, "text", i, NULL);
+        gtk_tree_view_column_set_sizing(col, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(col, larguras[i]);
+        gtk_tree_view_column_set_resizable(col, TRUE);
         gtk_tree_view_append_column(GTK_TREE_VIEW(treeview), col);
     }
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(treeview), TRUE);
 
     return treeview;
 }
 
 // Função para Atualizar a TreeView com as reservas ordenadas
 void atualizarTreeView(AppWidgets *widgets) {
-    GtkListStore *store;
-    GtkTreeIter iter;
-    Reserva *reserva;
-    
-    // Ordenar a lista de reservas usando Merge Sort
-    lista_reservas = merge_sort(lista_reservas);
-    
-    No* temp = lista_reservas;
-
-    // Obtém o modelo da TreeView
-    GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(widgets->treeview));
-    store = GTK_LIST_STORE(model);
-
-    // Limpa a lista existente
-    gtk_list_store_clear(store);
-
-    // Itera sobre as reservas e adiciona à TreeView
-    while (temp != NULL) {
-        reserva = &temp->reserva;
-        gtk_list_store_append(store, &iter);
-        
-        // Formata o preço com duas casas decimais e vírgula
-        char preco_str[20];
-        snprintf(preco_str, sizeof(preco_str), "R$%.2f", reserva->preco);
-        // Substitui ponto por vírgula
-        for(int i = 0; preco_str[i] != '\0'; i++) {
-            if(preco_str[i] == '.') {
-                preco_str[i] = ',';
-                break;
-            }
+    // A lista de reservas já é mantida ordenada por data na inserção; basta
+    // religar o modelo para que a TreeView releia o número de linhas
+    GtkTreeView *treeview = GTK_TREE_VIEW(widgets->treeview);
+    GtkTreeModel *model = g_object_ref(gtk_tree_view_get_model(treeview));
+    MODELO_RESERVAS(model)->stamp++;  // Invalida iters antigos
+    gtk_tree_view_set_model(treeview, NULL);
+    gtk_tree_view_set_model(treeview, model);
+    g_object_unref(model);
+}
+
+// Função para mostrar a ocupação de hoje a partir dos totais por dia
+void atualizarPainel(AppWidgets *widgets) {
+    AgregadoDia hoje = obterAgregadoDia(motor, data_hoje());
+    char receita_str[32];
+    formatar_preco(hoje.receita, receita_str, sizeof(receita_str));
+
+    char texto[160];
+    snprintf(texto, sizeof(texto), "Hoje: %d/%d quartos ocupados | %d/%d hóspedes | Receita do dia: %s",
+             hoje.quartos_ocupados, contarQuartos(motor), hoje.hospedes, capacidadeHotel(motor), receita_str);
+    gtk_label_set_text(GTK_LABEL(widgets->painel), texto);
+}
+
+#define LISTA_QUARTOS_MAX 50  // Quartos livres listados no combo
+
+// Widgets do diálogo de inserção usados para filtrar os quartos livres
+typedef struct {
+    GtkWidget *calendar;
+    GtkWidget *combo_quarto;
+    GtkWidget *spin_diarias;
+    GtkWidget *label_livres;
+} DialogoInsercao;
+
+// Função para preencher o combo com os primeiros quartos livres no período
+// escolhido (no máximo LISTA_QUARTOS_MAX; outros podem ser digitados),
+// mantendo o quarto escolhido quando ele continua livre
+static void atualizar_quartos_livres(GtkWidget *widget, gpointer data) {
+    (void)widget;
+    DialogoInsercao *dialogo = (DialogoInsercao *)data;
+    guint year, month, day;
+    gtk_calendar_get_date(GTK_CALENDAR(dialogo->calendar), &year, &month, &day);
+    int diarias = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(dialogo->spin_diarias));
+    DataCompacta inicio = data_para_dias(day, month + 1, year);
+
+    gchar *anterior = gtk_combo_box_text_get_active_text(GTK_COMBO_BOX_TEXT(dialogo->combo_quarto));
+    int quarto_anterior = anterior ? atoi(anterior) : 0;
+    g_free(anterior);
+
+    int livres[LISTA_QUARTOS_MAX];
+    int total = quartosLivres(motor, inicio, diarias, livres, LISTA_QUARTOS_MAX);
+    int listados = total < LISTA_QUARTOS_MAX ? total : LISTA_QUARTOS_MAX;
+
+    gtk_combo_box_text_remove_all(GTK_COMBO_BOX_TEXT(dialogo->combo_quarto));
+    int ativo = -1;
+    for (int i = 0; i < listados; i++) {
+        char quarto_str[12];
+        sprintf(quarto_str, "%d", livres[i]);
+        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(dialogo->combo_quarto), quarto_str);
+        if (livres[i] == quarto_anterior) {
+            ativo = i;
         }
+    }
+    GtkEntry *entry = GTK_ENTRY(gtk_bin_get_child(GTK_BIN(dialogo->combo_quarto)));
+    if (ativo >= 0) {
+        gtk_combo_box_set_active(GTK_COMBO_BOX(dialogo->combo_quarto), ativo);
+    } else if (quarto_anterior > 0 && isRoomAvailable(motor, quarto_anterior, inicio, diarias)) {
+        // Quarto digitado, fora da lista, que continua livre
+        char quarto_str[12];
+        sprintf(quarto_str, "%d", quarto_anterior);
+        gtk_entry_set_text(entry, quarto_str);
+    } else if (listados > 0) {
+        gtk_combo_box_set_active(GTK_COMBO_BOX(dialogo->combo_quarto), 0);
+    } else {
+        gtk_entry_set_text(entry, "");
+    }
 
-        gtk_list_store_set(store,
-                           &iter,
-                           0, reserva->reserva_id,
-                           1, reserva->quarto_id,
-                           2, reserva->nome_cliente,
-                           3, reserva->data_inicio,
-                           4, reserva->num_pessoas,
-                           5, reserva->num_diarias,
-                           6, preco_str, // Alterado para string
-                           -1);
-        temp = temp->prox;
+    char texto[64];
+    if (total > listados) {
+        snprintf(texto, sizeof(texto), "%d quartos livres (digite o número)", total);
+    } else {
+        snprintf(texto, sizeof(texto), "%d quartos livres", total);
     }
+    gtk_label_set_text(GTK_LABEL(dialogo->label_livres), texto);
 }
 
 // Callback para Inserir Reserva
@@ -402,7 +451,7 @@ void on_insert_reserva(GtkWidget *widget, gpointer data) {
     GtkWidget *dialog, *content_area;
     GtkWidget *grid;
     GtkWidget *label_nome, *entry_nome;
-    GtkWidget *label_quarto_num, *combo_quarto;
+    GtkWidget *label_quarto_num, *combo_quarto, *label_livres;
     GtkWidget *label_pessoas, *spin_pessoas;
     GtkWidget *label_diarias, *spin_diarias;
     GtkWidget *label_data;
@@ -443,15 +492,12 @@ void on_insert_reserva(GtkWidget *widget, gpointer data) {
     // Número do Quarto
     label_quarto_num = gtk_label_new("Número do Quarto:");
     gtk_widget_set_halign(label_quarto_num, GTK_ALIGN_END);
-    combo_quarto = gtk_combo_box_text_new();
-    for(int i = 1; i <= QUARTOS_DISPONIVEIS; i++) {
-        char quarto_str[3];
-        sprintf(quarto_str, "%d", i);
-        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_quarto), quarto_str);
-    }
-    gtk_combo_box_set_active(GTK_COMBO_BOX(combo_quarto), 0);
+    combo_quarto = gtk_combo_box_text_new_with_entry();
+    label_livres = gtk_label_new("");
+    gtk_widget_set_halign(label_livres, GTK_ALIGN_START);
     gtk_grid_attach(GTK_GRID(grid), label_quarto_num, 0, 2, 1, 1);
     gtk_grid_attach(GTK_GRID(grid), combo_quarto, 1, 2, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), label_livres, 2, 2, 1, 1);
 
     // Número de Pessoas
     label_pessoas = gtk_label_new("Número de Pessoas:");
@@ -467,6 +513,12 @@ void on_insert_reserva(GtkWidget *widget, gpointer data) {
     gtk_grid_attach(GTK_GRID(grid), label_diarias, 0, 4, 1, 1);
     gtk_grid_attach(GTK_GRID(grid), spin_diarias, 1, 4, 1, 1);
 
+    // O combo lista só os quartos livres para a data e o número de diárias
+    DialogoInsercao dialogo_insercao = {calendar, combo_quarto, spin_diarias, label_livres};
+    atualizar_quartos_livres(NULL, &dialogo_insercao);
+    g_signal_connect(calendar, "day-selected", G_CALLBACK(atualizar_quartos_livres), &dialogo_insercao);
+    g_signal_connect(spin_diarias, "value-changed", G_CALLBACK(atualizar_quartos_livres), &dialogo_insercao);
+
     gtk_widget_show_all(dialog);
 
     response = gtk_dialog_run(GTK_DIALOG(dialog));
@@ -495,8 +547,6 @@ void on_insert_reserva(GtkWidget *widget, gpointer data) {
             gtk_dialog_run(GTK_DIALOG(error_dialog));
             gtk_widget_destroy(error_dialog);
         } else {
-            struct tm new_start = parse_date(data_str);
-
             // Verificar data válida
             int data_valida = verificarDataValida(data_str);
             if (!data_valida) {
@@ -504,51 +554,50 @@ void on_insert_reserva(GtkWidget *widget, gpointer data) {
                                                                  GTK_DIALOG_MODAL,
                                                                  GTK_MESSAGE_ERROR,
                                                                  GTK_BUTTONS_OK,
-                                                                 "Data inválida! A data deve ser hoje ou uma data futura.");
+                                                                 "Data inválida! Use DD/MM/AAAA (ex.: 05/03/2026), com hoje ou uma data futura.");
                 gtk_dialog_run(GTK_DIALOG(error_dialog));
                 gtk_widget_destroy(error_dialog);
             } else {
-                // Verificar disponibilidade do quarto para todo o período
-                if(!isRoomAvailable(lista_reservas, quarto, new_start, diarias)) {
+                // Reservar o quarto: a conferência do período e da capacidade
+                // em cada dia da estadia e a inserção são uma só operação
+                Reserva nova_reserva;
+                strcpy(nova_reserva.nome_cliente, nome);
+                strcpy(nova_reserva.data_inicio, data_str);
+                nova_reserva.quarto_id = quarto;
+                nova_reserva.num_pessoas = pessoas;
+                nova_reserva.num_diarias = diarias;
+                nova_reserva.preco = 0.0; // Será calculado na função de inserção
+
+                // A TreeView recebe a nova linha pelo observador do modelo
+                int resultado = reservarQuarto(motor, &nova_reserva);
+                if (resultado != LOTE_OK) {
+                    const char *mensagem = "Selecione um quarto livre.";
+                    if (resultado == LOTE_CONFLITO_EXISTENTE) {
+                        mensagem = "Quarto já está reservado para o período selecionado.";
+                    } else if (resultado == LOTE_CAPACIDADE) {
+                        mensagem = "Capacidade do quarto ou do hotel excedida.";
+                    } else if (resultado == LOTE_QUARTO_INVALIDO) {
+                        mensagem = "O hotel não tem esse quarto.";
+                    } else if (resultado == LOTE_ERRO_DIARIO) {
+                        mensagem = "Não foi possível gravar a reserva no diário.";
+                    }
                     GtkWidget *error_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
                                                                      GTK_DIALOG_MODAL,
                                                                      GTK_MESSAGE_ERROR,
                                                                      GTK_BUTTONS_OK,
-                                                                     "Quarto já está reservado para o período selecionado.");
+                                                                     "%s", mensagem);
                     gtk_dialog_run(GTK_DIALOG(error_dialog));
                     gtk_widget_destroy(error_dialog);
                 } else {
-                    // Verificar capacidade total
-                    int totalPessoas = contarTotalPessoas(lista_reservas);
-                    if (totalPessoas + pessoas > CAPACIDADE_TOTAL) {
-                        GtkWidget *error_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
-                                                                         GTK_DIALOG_MODAL,
-                                                                         GTK_MESSAGE_ERROR,
-                                                                         GTK_BUTTONS_OK,
-                                                                         "Capacidade total de pessoas excedida.");
-                        gtk_dialog_run(GTK_DIALOG(error_dialog));
-                        gtk_widget_destroy(error_dialog);
-                    } else {
-                        // Inserir Reserva
-                        Reserva nova_reserva;
-                        strcpy(nova_reserva.nome_cliente, nome);
-                        strcpy(nova_reserva.data_inicio, data_str);
-                        nova_reserva.quarto_id = quarto;
-                        nova_reserva.num_pessoas = pessoas;
-                        nova_reserva.num_diarias = diarias;
-                        nova_reserva.preco = 0.0; // Será calculado na função de inserção
-
-                        lista_reservas = inserirReserva(lista_reservas, nova_reserva);
-                        atualizarTreeView(widgets);
-
-                        GtkWidget *info_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
-                                                                        GTK_DIALOG_MODAL,
-                                                                        GTK_MESSAGE_INFO,
-                                                                        GTK_BUTTONS_OK,
-                                                                        "Reserva realizada com sucesso!");
-                        gtk_dialog_run(GTK_DIALOG(info_dialog));
-                        gtk_widget_destroy(info_dialog);
-                    }
+                    atualizarPainel(widgets);
+
+                    GtkWidget *info_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
+                                                                    GTK_DIALOG_MODAL,
+                                                                    GTK_MESSAGE_INFO,
+                                                                    GTK_BUTTONS_OK,
+                                                                    "Reserva realizada com sucesso!");
+                    gtk_dialog_run(GTK_DIALOG(info_dialog));
+                    gtk_widget_destroy(info_dialog);
                 }
             }
         }
@@ -596,18 +645,20 @@ void on_remove_reserva(GtkWidget *widget, gpointer data) {
     if (response == GTK_RESPONSE_ACCEPT) {
         int id = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spin_id));
 
-        Reserva* reserva = buscarReserva(lista_reservas, id);
-        if (reserva == NULL) {
+        // A TreeView remove a linha pelo observador do modelo
+        int removida = removerReserva(motor, id);
+        if (removida <= 0) {
+            const char *mensagem = removida < 0 ? "Não foi possível gravar a remoção no diário!" :
+                                                  "Reserva não encontrada!";
             GtkWidget *error_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
                                                              GTK_DIALOG_MODAL,
                                                              GTK_MESSAGE_ERROR,
                                                              GTK_BUTTONS_OK,
-                                                             "Reserva não encontrada!");
+                                                             "%s", mensagem);
             gtk_dialog_run(GTK_DIALOG(error_dialog));
             gtk_widget_destroy(error_dialog);
         } else {
-            lista_reservas = removerReserva(lista_reservas, id);
-            atualizarTreeView(widgets);
+            atualizarPainel(widgets);
 
             GtkWidget *info_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
                                                             GTK_DIALOG_MODAL,
@@ -629,6 +680,7 @@ void on_search_reserva(GtkWidget *widget, gpointer data) {
     GtkWidget *dialog, *content_area;
     GtkWidget *grid;
     GtkWidget *label_id, *spin_id;
+    GtkWidget *label_nome, *entry_nome, *check_exato;
     gint response;
 
     dialog = gtk_dialog_new_with_buttons("Buscar Reserva",
@@ -655,14 +707,64 @@ void on_search_reserva(GtkWidget *widget, gpointer data) {
     gtk_grid_attach(GTK_GRID(grid), label_id, 0, 0, 1, 1);
     gtk_grid_attach(GTK_GRID(grid), spin_id, 1, 0, 1, 1);
 
+    // Nome do Cliente (tem prioridade sobre o ID quando preenchido)
+    label_nome = gtk_label_new("ou Nome do Cliente:");
+    gtk_widget_set_halign(label_nome, GTK_ALIGN_END);
+    entry_nome = gtk_entry_new();
+    check_exato = gtk_check_button_new_with_label("Somente nome completo");
+    gtk_grid_attach(GTK_GRID(grid), label_nome, 0, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), entry_nome, 1, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(grid), check_exato, 1, 2, 1, 1);
+
     gtk_widget_show_all(dialog);
 
     response = gtk_dialog_run(GTK_DIALOG(dialog));
-    if (response == GTK_RESPONSE_ACCEPT) {
+    const gchar *nome = gtk_entry_get_text(GTK_ENTRY(entry_nome));
+    char chave[NOME_CHAVE_MAX];
+    if (response == GTK_RESPONSE_ACCEPT && normalizar_nome(nome, chave) > 0) {
+        int prefixo = !gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(check_exato));
+        int *ids;
+        int total = buscarReservasPorNome(motor, nome, prefixo, &ids);
+        if (total == 0) {
+            GtkWidget *error_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
+                                                             GTK_DIALOG_MODAL,
+                                                             GTK_MESSAGE_ERROR,
+                                                             GTK_BUTTONS_OK,
+                                                             "Nenhuma reserva encontrada para \"%s\".", nome);
+            gtk_dialog_run(GTK_DIALOG(error_dialog));
+            gtk_widget_destroy(error_dialog);
+        } else {
+            // Lista as reservas encontradas, limitando o tamanho da mensagem
+            const int max_linhas = 20;
+            GString *texto = g_string_new(NULL);
+            g_string_append_printf(texto, "%d reserva(s) encontrada(s):\n", total);
+            for (int i = 0; i < total && i < max_linhas; i++) {
+                Reserva reserva;
+                if (buscarReserva(motor, ids[i], &reserva)) {
+                    g_string_append_printf(texto, "\nID %d - %s - Quarto %d - %s (%d diária(s))",
+                                           reserva.reserva_id, reserva.nome_cliente, reserva.quarto_id,
+                                           reserva.data_inicio, reserva.num_diarias);
+                }
+            }
+            if (total > max_linhas) {
+                g_string_append_printf(texto, "\n\n... e mais %d.", total - max_linhas);
+            }
+
+            GtkWidget *info_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
+                                                            GTK_DIALOG_MODAL,
+                                                            GTK_MESSAGE_INFO,
+                                                            GTK_BUTTONS_OK,
+                                                            "%s", texto->str);
+            gtk_dialog_run(GTK_DIALOG(info_dialog));
+            gtk_widget_destroy(info_dialog);
+            g_string_free(texto, TRUE);
+        }
+        free(ids);
+    } else if (response == GTK_RESPONSE_ACCEPT) {
         int id = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(spin_id));
 
-        Reserva* reserva = buscarReserva(lista_reservas, id);
-        if (reserva == NULL) {
+        Reserva reserva;
+        if (!buscarReserva(motor, id, &reserva)) {
             GtkWidget *error_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
                                                              GTK_DIALOG_MODAL,
                                                              GTK_MESSAGE_ERROR,
@@ -674,19 +776,12 @@ void on_search_reserva(GtkWidget *widget, gpointer data) {
             // Exibir detalhes da reserva
             char detalhes[512];
             sprintf(detalhes, "ID da Reserva: %d\nQuarto: %d\nCliente: %s\nData de Início: %s\nPessoas: %d\nDiárias: %d\nPreço: ",
-                    reserva->reserva_id, reserva->quarto_id, reserva->nome_cliente, reserva->data_inicio,
-                    reserva->num_pessoas, reserva->num_diarias);
+                    reserva.reserva_id, reserva.quarto_id, reserva.nome_cliente, reserva.data_inicio,
+                    reserva.num_pessoas, reserva.num_diarias);
 
             // Formatar o preço com duas casas decimais e vírgula
             char preco_str[20];
-            snprintf(preco_str, sizeof(preco_str), "R$%.2f", reserva->preco);
-            // Substitui ponto por vírgula
-            for(int i = 0; preco_str[i] != '\0'; i++) {
-                if(preco_str[i] == '.') {
-                    preco_str[i] = ',';
-                    break;
-                }
-            }
+            formatar_preco(reserva.preco, preco_str, sizeof(preco_str));
             strcat(detalhes, preco_str);
 
             GtkWidget *info_dialog = gtk_message_dialog_new(GTK_WINDOW(dialog),
@@ -706,6 +801,13 @@ void on_search_reserva(GtkWidget *widget, gpointer data) {
 void on_display_reservas(GtkWidget *widget, gpointer data) {
     AppWidgets *widgets = (AppWidgets *)data;
     atualizarTreeView(widgets);
+    atualizarPainel(widgets);
+}
+
+// Temporizador que fecha o grupo de operações pendentes no diário
+gboolean sincronizar_diario_periodico(gpointer data) {
+    diario_sincronizar(motor);
+    return TRUE; // Mantém o temporizador ativo
 }
 
 // Função para Aplicar CSS
@@ -722,11 +824,61 @@ int main(int argc, char *argv[]) {
     // Define a localidade para usar vírgula como separador decimal
     setlocale(LC_ALL, "pt_BR.UTF-8");
 
+    motor = criarMotorReservas();
+
+    // Layout do hotel; sem o arquivo o hotel tem os quartos 1 a QUARTOS_PADRAO
+    int quartos = carregarQuartos(motor, ARQUIVO_QUARTOS);
+    if (quartos < 0) {
+        printf("O arquivo %s é inválido.\n", ARQUIVO_QUARTOS);
+        return 1;
+    }
+
+    // Tarifas do hotel; sem o arquivo vale PRECO_RESERVA para todos os quartos
+    if (carregarTarifas(motor, ARQUIVO_TARIFAS) < 0) {
+        printf("O arquivo %s é inválido.\n", ARQUIVO_TARIFAS);
+        return 1;
+    }
+
+    // Modo sem interface: importação ou exportação de reservas em CSV e
+    // relatório anual de receita
+    if (argc == 3 && (strcmp(argv[1], "--importar") == 0 || strcmp(argv[1], "--exportar") == 0 ||
+                      strcmp(argv[1], "--relatorio") == 0)) {
+        return executarLinhaComando(argv[1], argv[2]);
+    }
+
     gtk_init(&argc, &argv);
 
-    // Inicializa a lista e adiciona reservas iniciais
-    lista_reservas = inicializarLista();
-    adicionarReservasIniciais(lista_reservas);
+    // Carrega as reservas gravadas; na primeira execução usa as reservas iniciais
+    int carregado = carregarReservas(motor, ARQUIVO_RESERVAS);
+    if (carregado < 0) {
+        // Não sobrescreve um arquivo danificado com dados novos
+        GtkWidget *error_dialog = gtk_message_dialog_new(NULL,
+                                                         GTK_DIALOG_MODAL,
+                                                         GTK_MESSAGE_ERROR,
+                                                         GTK_BUTTONS_OK,
+                                                         "O arquivo %s está corrompido.", ARQUIVO_RESERVAS);
+        gtk_dialog_run(GTK_DIALOG(error_dialog));
+        gtk_widget_destroy(error_dialog);
+        return 1;
+    } else if (carregado == 0) {
+        // As reservas iniciais são do layout padrão; com quartos.txt o hotel começa vazio
+        if (quartos == 0) {
+            adicionarReservasIniciais();
+        }
+        salvarReservas(motor, ARQUIVO_RESERVAS);
+    }
+
+    // Reaplica as operações registradas após o último snapshot
+    if (diario_reproduzir(motor, ARQUIVO_DIARIO) < 0 || !diario_abrir(motor, ARQUIVO_DIARIO, ARQUIVO_RESERVAS, DIARIO_JANELA_MS)) {
+        GtkWidget *error_dialog = gtk_message_dialog_new(NULL,
+                                                         GTK_DIALOG_MODAL,
+                                                         GTK_MESSAGE_ERROR,
+                                                         GTK_BUTTONS_OK,
+                                                         "Não foi possível abrir o diário %s.", ARQUIVO_DIARIO);
+        gtk_dialog_run(GTK_DIALOG(error_dialog));
+        gtk_widget_destroy(error_dialog);
+        return 1;
+    }
 
     // Cria os widgets principais
     AppWidgets *widgets = g_slice_new(AppWidgets);
@@ -778,6 +930,11 @@ int main(int argc, char *argv[]) {
     gtk_container_add(GTK_CONTAINER(scrolled_window), widgets->treeview);
     gtk_box_pack_start(GTK_BOX(vbox), scrolled_window, TRUE, TRUE, 0);
 
+    // Painel com a ocupação de hoje
+    widgets->painel = gtk_label_new(NULL);
+    gtk_widget_set_halign(widgets->painel, GTK_ALIGN_START);
+    gtk_box_pack_start(GTK_BOX(vbox), widgets->painel, FALSE, FALSE, 5);
+
     // Conecta os sinais dos menu items
     g_signal_connect(menuitem_sair, "activate", G_CALLBACK(gtk_main_quit), NULL);
     g_signal_connect(menuitem_inserir, "activate", G_CALLBACK(on_insert_reserva), widgets);
@@ -790,13 +947,20 @@ int main(int argc, char *argv[]) {
 
     // Atualiza a TreeView com as reservas iniciais
     atualizarTreeView(widgets);
+    atualizarPainel(widgets);
+
+    // Sincroniza o diário periodicamente, limitando a espera de cada operação à janela
+    g_timeout_add(DIARIO_JANELA_MS, sincronizar_diario_periodico, NULL);
 
     // Mostra todos os widgets
     gtk_widget_show_all(widgets->window);
 
     gtk_main();
 
-    // Libera a memória alocada para a lista
-    // (Opcional: implementar uma função para liberar a lista)
+    // Grava um snapshot atualizado e fecha o diário
+    diario_compactar(motor);
+
+    // Fecha o diário e libera a memória do motor
+    liberarMotorReservas(motor);
     return 0;
 }
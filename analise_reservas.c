@@ -0,0 +1,306 @@
+// analise_reservas.c
+// Implementação dos relatórios de receita e ocupação (ver analise_reservas.h)
+#include "analise_reservas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ANALISE_X86 1
+#include <immintrin.h>
+#endif
+
+// Núcleos de soma. Cada um percorre as colunas a partir da linha 0, soma em
+// 't' as linhas com início em [de, ate) e retorna quantas linhas consumiu;
+// o restante (menos que uma largura de vetor) fica para o núcleo escalar.
+// Linhas livres têm início DATA_INVALIDA e de > DATA_INVALIDA, então ficam
+// de fora sem consultar reserva_id.
+enum { NUCLEO_ESCALAR, NUCLEO_SSE2, NUCLEO_AVX2 };
+
+static const char* const NOMES_NUCLEO[] = {"escalar", "sse2", "avx2"};
+
+static atomic_int nucleo_escolhido = -1;
+
+static void somar_escalar(const ColunasReservas* c, long primeira, DataCompacta de, DataCompacta ate,
+                          TotaisReservas* t) {
+    for (long i = primeira; i < c->linhas; i++) {
+        if (c->inicio[i] >= de && c->inicio[i] < ate) {
+            t->reservas++;
+            t->pessoas += c->num_pessoas[i];
+            t->diarias += c->num_diarias[i];
+            t->receita += c->preco[i];
+        }
+    }
+}
+
+#ifdef ANALISE_X86
+// Máscara das linhas no período: x > de - 1 e ate > x. As somas de inteiros
+// são estendidas para 64 bits; para os preços (double) cada metade da máscara
+// é estendida para 64 bits por linha.
+__attribute__((target("sse2")))
+static long somar_sse2(const ColunasReservas* c, DataCompacta de, DataCompacta ate, TotaisReservas* t) {
+    const __m128i limite_inf = _mm_set1_epi32(de - 1);
+    const __m128i limite_sup = _mm_set1_epi32(ate);
+    __m128i contagem = _mm_setzero_si128();
+    __m128i pessoas = _mm_setzero_si128();
+    __m128i diarias = _mm_setzero_si128();
+    __m128d receita_baixa = _mm_setzero_pd();
+    __m128d receita_alta = _mm_setzero_pd();
+    long i = 0;
+    for (; i + 4 <= c->linhas; i += 4) {
+        __m128i inicio = _mm_loadu_si128((const __m128i*) (c->inicio + i));
+        __m128i mascara = _mm_and_si128(_mm_cmpgt_epi32(inicio, limite_inf), _mm_cmpgt_epi32(limite_sup, inicio));
+        contagem = _mm_sub_epi32(contagem, mascara);
+
+        __m128i p = _mm_and_si128(_mm_loadu_si128((const __m128i*) (c->num_pessoas + i)), mascara);
+        __m128i sinal = _mm_srai_epi32(p, 31);
+        pessoas = _mm_add_epi64(pessoas, _mm_unpacklo_epi32(p, sinal));
+        pessoas = _mm_add_epi64(pessoas, _mm_unpackhi_epi32(p, sinal));
+
+        __m128i d = _mm_and_si128(_mm_loadu_si128((const __m128i*) (c->num_diarias + i)), mascara);
+        sinal = _mm_srai_epi32(d, 31);
+        diarias = _mm_add_epi64(diarias, _mm_unpacklo_epi32(d, sinal));
+        diarias = _mm_add_epi64(diarias, _mm_unpackhi_epi32(d, sinal));
+
+        __m128d mascara_baixa = _mm_castsi128_pd(_mm_unpacklo_epi32(mascara, mascara));
+        __m128d mascara_alta = _mm_castsi128_pd(_mm_unpackhi_epi32(mascara, mascara));
+        receita_baixa = _mm_add_pd(receita_baixa, _mm_and_pd(_mm_loadu_pd(c->preco + i), mascara_baixa));
+        receita_alta = _mm_add_pd(receita_alta, _mm_and_pd(_mm_loadu_pd(c->preco + i + 2), mascara_alta));
+    }
+
+    int32_t cont[4];
+    int64_t soma_p[2], soma_d[2];
+    double soma_r[2];
+    _mm_storeu_si128((__m128i*) cont, contagem);
+    _mm_storeu_si128((__m128i*) soma_p, pessoas);
+    _mm_storeu_si128((__m128i*) soma_d, diarias);
+    _mm_storeu_pd(soma_r, _mm_add_pd(receita_baixa, receita_alta));
+    t->reservas += (long) cont[0] + cont[1] + cont[2] + cont[3];
+    t->pessoas += (long) (soma_p[0] + soma_p[1]);
+    t->diarias += (long) (soma_d[0] + soma_d[1]);
+    t->receita += soma_r[0] + soma_r[1];
+    return i;
+}
+
+__attribute__((target("avx2")))
+static long somar_avx2(const ColunasReservas* c, DataCompacta de, DataCompacta ate, TotaisReservas* t) {
+    const __m256i limite_inf = _mm256_set1_epi32(de - 1);
+    const __m256i limite_sup = _mm256_set1_epi32(ate);
+    __m256i contagem = _mm256_setzero_si256();
+    __m256i pessoas = _mm256_setzero_si256();
+    __m256i diarias = _mm256_setzero_si256();
+    __m256d receita_baixa = _mm256_setzero_pd();
+    __m256d receita_alta = _mm256_setzero_pd();
+    long i = 0;
+    for (; i + 8 <= c->linhas; i += 8) {
+        __m256i inicio = _mm256_loadu_si256((const __m256i*) (c->inicio + i));
+        __m256i mascara = _mm256_and_si256(_mm256_cmpgt_epi32(inicio, limite_inf),
+                                           _mm256_cmpgt_epi32(limite_sup, inicio));
+        contagem = _mm256_sub_epi32(contagem, mascara);
+
+        __m256i p = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (c->num_pessoas + i)), mascara);
+        pessoas = _mm256_add_epi64(pessoas, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+        pessoas = _mm256_add_epi64(pessoas, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+
+        __m256i d = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (c->num_diarias + i)), mascara);
+        diarias = _mm256_add_epi64(diarias, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(d)));
+        diarias = _mm256_add_epi64(diarias, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(d, 1)));
+
+        __m256d mascara_baixa = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(mascara)));
+        __m256d mascara_alta = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(mascara, 1)));
+        receita_baixa = _mm256_add_pd(receita_baixa, _mm256_and_pd(_mm256_loadu_pd(c->preco + i), mascara_baixa));
+        receita_alta = _mm256_add_pd(receita_alta, _mm256_and_pd(_mm256_loadu_pd(c->preco + i + 4), mascara_alta));
+    }
+
+    int32_t cont[8];
+    int64_t soma_p[4], soma_d[4];
+    double soma_r[4];
+    _mm256_storeu_si256((__m256i*) cont, contagem);
+    _mm256_storeu_si256((__m256i*) soma_p, pessoas);
+    _mm256_storeu_si256((__m256i*) soma_d, diarias);
+    _mm256_storeu_pd(soma_r, _mm256_add_pd(receita_baixa, receita_alta));
+    for (int k = 0; k < 8; k++) {
+        t->reservas += cont[k];
+    }
+    for (int k = 0; k < 4; k++) {
+        t->pessoas += (long) soma_p[k];
+        t->diarias += (long) soma_d[k];
+        t->receita += soma_r[k];
+    }
+    return i;
+}
+#endif
+
+// Função para escolher o núcleo na primeira chamada: o mais largo que o
+// processador suporta
+static int nucleo_atual() {
+    int nucleo = atomic_load(&nucleo_escolhido);
+    if (nucleo >= 0) {
+        return nucleo;
+    }
+    nucleo = NUCLEO_ESCALAR;
+#ifdef ANALISE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        nucleo = NUCLEO_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        nucleo = NUCLEO_SSE2;
+    }
+#endif
+    atomic_store(&nucleo_escolhido, nucleo);
+    return nucleo;
+}
+
+const char* nucleoAnalise() {
+    return NOMES_NUCLEO[nucleo_atual()];
+}
+
+int definirNucleoAnalise(const char* nome) {
+    for (int nucleo = NUCLEO_AVX2; nucleo >= NUCLEO_ESCALAR; nucleo--) {
+        if (strcmp(nome, NOMES_NUCLEO[nucleo]) != 0) {
+            continue;
+        }
+#ifdef ANALISE_X86
+        __builtin_cpu_init();
+        if ((nucleo == NUCLEO_AVX2 && !__builtin_cpu_supports("avx2")) ||
+            (nucleo == NUCLEO_SSE2 && !__builtin_cpu_supports("sse2"))) {
+            return 0;
+        }
+#else
+        if (nucleo != NUCLEO_ESCALAR) {
+            return 0;
+        }
+#endif
+        atomic_store(&nucleo_escolhido, nucleo);
+        return 1;
+    }
+    return 0;
+}
+
+// Períodos começando antes de DATA_INVALIDA + 1 incluiriam as linhas livres
+static DataCompacta limitar_inicio(DataCompacta de) {
+    return de > DATA_INVALIDA ? de : DATA_INVALIDA + 1;
+}
+
+TotaisReservas totalizarReservas(MotorReservas* motor, DataCompacta de, DataCompacta ate) {
+    TotaisReservas totais = {0, 0, 0, 0.0};
+    de = limitar_inicio(de);
+    if (ate <= de) {
+        return totais;
+    }
+
+    travarLeituraReservas(motor);
+    ColunasReservas colunas = obterColunasReservas(motor);
+    long feitas = 0;
+    switch (nucleo_atual()) {
+#ifdef ANALISE_X86
+        case NUCLEO_AVX2:
+            feitas = somar_avx2(&colunas, de, ate, &totais);
+            break;
+        case NUCLEO_SSE2:
+            feitas = somar_sse2(&colunas, de, ate, &totais);
+            break;
+#endif
+        default:
+            break;
+    }
+    somar_escalar(&colunas, feitas, de, ate, &totais);
+    destravarLeituraReservas(motor);
+    return totais;
+}
+
+// Agrupar por mês ou por quarto é uma soma espalhada (cada linha cai em um
+// grupo diferente), que não se beneficia de SIMD sem instruções de conflito;
+// estas funções fazem uma passada escalar lendo só as colunas necessárias.
+int resumirPorMes(MotorReservas* motor, DataCompacta de, DataCompacta ate, ResumoMes* meses, int max_meses) {
+    de = limitar_inicio(de);
+    if (ate <= de || (long) ate - de > ANALISE_MAX_DIAS) {
+        return -1;
+    }
+
+    // Meses que tocam o período e o mês de cada dia do período
+    int dias = (int) (ate - de);
+    int* mes_do_dia = (int*) malloc((size_t) dias * sizeof(int));
+    if (mes_do_dia == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    int dia, mes, ano;
+    dias_para_data(de, &dia, &mes, &ano);
+    int num_meses = 0;
+    DataCompacta cursor = de;
+    while (cursor < ate) {
+        DataCompacta fim = data_para_dias(1, mes, ano) + diasNoMes(mes, ano);
+        if (fim > ate) {
+            fim = ate;
+        }
+        if (num_meses < max_meses) {
+            ResumoMes* resumo = &meses[num_meses];
+            memset(resumo, 0, sizeof(*resumo));
+            resumo->ano = ano;
+            resumo->mes = mes;
+            resumo->dias = (int) (fim - cursor);
+        }
+        for (; cursor < fim; cursor++) {
+            mes_do_dia[cursor - de] = num_meses;
+        }
+        num_meses++;
+        if (++mes > 12) {
+            mes = 1;
+            ano++;
+        }
+    }
+
+    int usados = num_meses < max_meses ? num_meses : max_meses;
+    int quartos = contarQuartos(motor);
+    travarLeituraReservas(motor);
+    ColunasReservas c = obterColunasReservas(motor);
+    for (long i = 0; i < c.linhas; i++) {
+        if (c.inicio[i] < de || c.inicio[i] >= ate) {
+            continue;
+        }
+        int k = mes_do_dia[c.inicio[i] - de];
+        if (k >= usados) {
+            continue;
+        }
+        TotaisReservas* t = &meses[k].totais;
+        t->reservas++;
+        t->pessoas += c.num_pessoas[i];
+        t->diarias += c.num_diarias[i];
+        t->receita += c.preco[i];
+    }
+    destravarLeituraReservas(motor);
+    free(mes_do_dia);
+
+    for (int k = 0; k < usados; k++) {
+        ResumoMes* resumo = &meses[k];
+        double disponiveis = (double) quartos * resumo->dias;
+        resumo->adr = resumo->totais.diarias > 0 ? resumo->totais.receita / resumo->totais.diarias : 0.0;
+        resumo->revpar = resumo->totais.receita / disponiveis;
+        resumo->ocupacao = resumo->totais.diarias / disponiveis;
+    }
+    return num_meses;
+}
+
+void totalizarPorQuarto(MotorReservas* motor, DataCompacta de, DataCompacta ate, TotaisReservas* por_quarto) {
+    memset(por_quarto, 0, (size_t) contarQuartos(motor) * sizeof(TotaisReservas));
+    de = limitar_inicio(de);
+    if (ate <= de) {
+        return;
+    }
+
+    travarLeituraReservas(motor);
+    ColunasReservas c = obterColunasReservas(motor);
+    for (long i = 0; i < c.linhas; i++) {
+        if (c.inicio[i] < de || c.inicio[i] >= ate || c.posicao_quarto[i] < 0) {
+            continue;
+        }
+        TotaisReservas* t = &por_quarto[c.posicao_quarto[i]];
+        t->reservas++;
+        t->pessoas += c.num_pessoas[i];
+        t->diarias += c.num_diarias[i];
+        t->receita += c.preco[i];
+    }
+    destravarLeituraReservas(motor);
+}
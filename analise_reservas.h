@@ -0,0 +1,50 @@
+// analise_reservas.h
+// Relatórios de receita e ocupação sobre as colunas do motor de reservas
+// (obterColunasReservas): totais, média por diária (ADR), receita por quarto
+// disponível (RevPAR) e agrupamentos por mês e por quarto. As somas usam
+// instruções SIMD (AVX2 ou SSE2, escolhidas na execução) quando disponíveis.
+//
+// Cada reserva entra no período pela data de início: uma estadia que cruza a
+// virada do mês conta inteira no mês de entrada.
+#ifndef ANALISE_RESERVAS_H
+#define ANALISE_RESERVAS_H
+
+#include "motor_reservas.h"
+
+typedef struct {
+    long reservas;
+    long pessoas;
+    long diarias;    // Diárias vendidas (quartos-noite)
+    double receita;
+} TotaisReservas;
+
+typedef struct {
+    int ano;
+    int mes;            // 1 a 12
+    int dias;           // Dias do mês dentro do período
+    TotaisReservas totais;
+    double adr;         // Receita por diária vendida
+    double revpar;      // Receita por quarto disponível por dia
+    double ocupacao;    // Diárias vendidas / (quartos * dias), de 0 a 1
+} ResumoMes;
+
+// Totais das reservas com início em [de, ate)
+TotaisReservas totalizarReservas(MotorReservas* motor, DataCompacta de, DataCompacta ate);
+
+// Resumo de cada mês que toca [de, ate), em ordem, nos primeiros 'max_meses'
+// itens de 'meses'. Retorna quantos meses o período tem ou -1 se o período
+// for vazio ou maior que ANALISE_MAX_DIAS.
+#define ANALISE_MAX_DIAS (366 * 200)
+int resumirPorMes(MotorReservas* motor, DataCompacta de, DataCompacta ate, ResumoMes* meses, int max_meses);
+
+// Totais das reservas com início em [de, ate) por quarto; 'por_quarto' tem
+// contarQuartos itens, indexados pela posição do quarto (quartoNaPosicao)
+void totalizarPorQuarto(MotorReservas* motor, DataCompacta de, DataCompacta ate, TotaisReservas* por_quarto);
+
+// Conjunto de instruções usado nas somas: "avx2", "sse2" ou "escalar".
+// O padrão é o mais largo que o processador suporta; definirNucleoAnalise
+// troca (para comparações) e retorna 0 se o processador não tiver o pedido.
+const char* nucleoAnalise();
+int definirNucleoAnalise(const char* nome);
+
+#endif
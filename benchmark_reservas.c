@@ -0,0 +1,430 @@
+// benchmark_reservas.c
+// Medição das operações principais do motor de reservas sobre um hotel
+// sintético: inserção, busca por id, disponibilidade, quartos livres,
+// capacidade, listagem, soma sobre as colunas, relatórios de receita (com
+// cada núcleo SIMD disponível), inclusão em lote (com ordenação), consultas
+// de uma rede de hotéis (em paralelo e hotel a hotel) e remoção.
+// Para cada operação mostra o tempo médio (ns/op), a vazão e as latências
+// p50 e p99.
+//
+// Uso: benchmark_reservas [--reservas N] [--quartos Q] [--dias D]
+//                         [--consultas C] [--repeticoes R] [--semente S]
+//                         [--hoteis H]
+//
+// O hotel tem Q quartos (até QUARTOS_MAX), numerados de 1 a Q, com
+// CAPACIDADE_QUARTO pessoas cada. As reservas de cada quarto não se sobrepõem
+// e ficam espalhadas por D dias a partir de 01/01/2030. A rede tem H hotéis
+// iguais a esse. Cada operação individual é cronometrada, então os
+// tempos incluem a leitura do relógio (dezenas de ns).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "motor_reservas.h"
+#include "analise_reservas.h"
+#include "rede_hoteis.h"
+
+#define CAPACIDADE_QUARTO 4
+
+typedef struct {
+    long reservas;
+    int quartos;
+    int dias;
+    long consultas;
+    int repeticoes;
+    unsigned semente;
+    int hoteis;
+} Parametros;
+
+// Gerador pseudoaleatório próprio (xorshift32), para resultados iguais em
+// todas as plataformas com a mesma semente
+static unsigned estado_aleatorio = 2463534242u;
+
+static unsigned aleatorio() {
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// Função para obter um relógio monotônico em nanossegundos
+static double agora_ns() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequencia;
+    LARGE_INTEGER contador;
+    if (frequencia.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequencia);
+    }
+    QueryPerformanceCounter(&contador);
+    return (double) contador.QuadPart * 1e9 / (double) frequencia.QuadPart;
+#else
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double) agora.tv_sec * 1e9 + (double) agora.tv_nsec;
+#endif
+}
+
+static void* alocar(size_t bytes) {
+    void* p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    return p;
+}
+
+static int comparar_double(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Função para imprimir uma linha do relatório a partir dos tempos de cada operação
+static void relatar(const char* nome, double* amostras, long n) {
+    double total = 0.0;
+    for (long i = 0; i < n; i++) {
+        total += amostras[i];
+    }
+    qsort(amostras, (size_t) n, sizeof(double), comparar_double);
+    double media = n > 0 ? total / n : 0.0;
+    double p50 = n > 0 ? amostras[(n - 1) / 2] : 0.0;
+    double p99 = n > 0 ? amostras[(long) ((n - 1) * 0.99)] : 0.0;
+    printf("%-26s %10ld %14.1f %14.0f %12.1f %12.1f\n", nome, n, media,
+           media > 0.0 ? 1e9 / media : 0.0, p50, p99);
+}
+
+static void embaralhar(Reserva* reservas, long n) {
+    for (long i = n - 1; i > 0; i--) {
+        long j = (long) (aleatorio() % (unsigned) (i + 1));
+        Reserva temp = reservas[i];
+        reservas[i] = reservas[j];
+        reservas[j] = temp;
+    }
+}
+
+// Função para gerar as reservas do hotel sintético: em cada quarto, uma
+// reserva por faixa de dias consecutiva, sem sobreposição
+static Reserva* gerar_reservas(const Parametros* p, DataCompacta base) {
+    Reserva* reservas = (Reserva*) alocar((size_t) p->reservas * sizeof(Reserva));
+    int max_pessoas = CAPACIDADE_QUARTO;
+    long k = 0;
+    for (int q = 0; q < p->quartos; q++) {
+        long no_quarto = p->reservas / p->quartos + (q < p->reservas % p->quartos);
+        int faixa = no_quarto > 0 ? (int) (p->dias / no_quarto) : 1;
+        if (faixa < 1) {
+            faixa = 1;
+        }
+        DataCompacta cursor = base;
+        for (long i = 0; i < no_quarto; i++, k++) {
+            Reserva* r = &reservas[k];
+            memset(r, 0, sizeof(*r));
+            int limite = faixa < 7 ? faixa : 7;
+            r->quarto_id = q + 1;
+            r->num_diarias = 1 + (int) (aleatorio() % (unsigned) limite);
+            r->num_pessoas = 1 + (int) (aleatorio() % (unsigned) max_pessoas);
+            formatar_data_compacta(cursor + (DataCompacta) (aleatorio() % (unsigned) (faixa - r->num_diarias + 1)),
+                                   r->data_inicio);
+            snprintf(r->nome_cliente, sizeof(r->nome_cliente), "Cliente %ld", k);
+            cursor += faixa;
+        }
+    }
+    return reservas;
+}
+
+// Função para criar um motor com o layout do hotel sintético
+static MotorReservas* criar_hotel(const Parametros* p) {
+    Quarto* quartos = (Quarto*) alocar((size_t) p->quartos * sizeof(Quarto));
+    for (int q = 0; q < p->quartos; q++) {
+        quartos[q].numero = q + 1;
+        quartos[q].andar = q / 100;
+        quartos[q].tipo = 0;
+        quartos[q].capacidade = CAPACIDADE_QUARTO;
+    }
+    MotorReservas* motor = criarMotorReservas();
+    definirQuartos(motor, quartos, p->quartos, 0);
+    free(quartos);
+    return motor;
+}
+
+static int ler_parametros(int argc, char* argv[], Parametros* p) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return 0;
+        }
+        long valor = strtol(argv[i + 1], NULL, 10);
+        if (strcmp(argv[i], "--reservas") == 0) {
+            p->reservas = valor;
+        } else if (strcmp(argv[i], "--quartos") == 0) {
+            p->quartos = (int) valor;
+        } else if (strcmp(argv[i], "--dias") == 0) {
+            p->dias = (int) valor;
+        } else if (strcmp(argv[i], "--consultas") == 0) {
+            p->consultas = valor;
+        } else if (strcmp(argv[i], "--repeticoes") == 0) {
+            p->repeticoes = (int) valor;
+        } else if (strcmp(argv[i], "--semente") == 0) {
+            p->semente = (unsigned) valor;
+        } else if (strcmp(argv[i], "--hoteis") == 0) {
+            p->hoteis = (int) valor;
+        } else {
+            return 0;
+        }
+        i++;
+    }
+    return p->reservas >= 1 && p->quartos >= 1 && p->quartos <= QUARTOS_MAX &&
+           p->dias >= 1 && p->consultas >= 1 && p->repeticoes >= 1 && p->semente != 0 &&
+           p->hoteis >= 1 && p->hoteis <= REDE_MAX_HOTEIS;
+}
+
+int main(int argc, char* argv[]) {
+    Parametros p = {100000, QUARTOS_PADRAO, 3650, 200000, 20, 2463534242u, 8};
+    if (!ler_parametros(argc, argv, &p)) {
+        printf("Uso: %s [--reservas N] [--quartos Q (1..%d)] [--dias D] [--consultas C] [--repeticoes R] [--semente S]"
+               " [--hoteis H (1..%d)]\n", argv[0], QUARTOS_MAX, REDE_MAX_HOTEIS);
+        return 1;
+    }
+    estado_aleatorio = p.semente;
+
+    DataCompacta base = data_para_dias(1, 1, 2030);
+    Reserva* reservas = gerar_reservas(&p, base);
+    embaralhar(reservas, p.reservas);
+    long maior_amostra = p.reservas > p.consultas ? p.reservas : p.consultas;
+    double* amostras = (double*) alocar((size_t) maior_amostra * sizeof(double));
+    int* ids = (int*) alocar((size_t) p.reservas * sizeof(int));
+
+    printf("Hotel sintético: %ld reservas, %d quartos, %d dias, %ld consultas, %d repetições\n\n",
+           p.reservas, p.quartos, p.dias, p.consultas, p.repeticoes);
+    printf("%-26s %10s %14s %14s %12s %12s\n", "operação", "ops", "ns/op", "ops/s", "p50 (ns)", "p99 (ns)");
+
+    // Inserção pelo caminho completo (conferência do quarto e da capacidade)
+    MotorReservas* motor = criar_hotel(&p);
+    long inseridas = 0;
+    for (long i = 0; i < p.reservas; i++) {
+        Reserva r = reservas[i];
+        double t0 = agora_ns();
+        int resultado = reservarQuarto(motor, &r);
+        amostras[i] = agora_ns() - t0;
+        if (resultado == LOTE_OK) {
+            ids[inseridas++] = r.reserva_id;
+        }
+    }
+    relatar("reservarQuarto", amostras, p.reservas);
+    if (inseridas != p.reservas) {
+        printf("  (%ld reservas recusadas na geração)\n", p.reservas - inseridas);
+    }
+    if (inseridas == 0) {
+        printf("Nenhuma reserva inserida.\n");
+        return 1;
+    }
+
+    // Busca por id, só de ids existentes
+    for (long i = 0; i < p.consultas; i++) {
+        Reserva encontrada;
+        int id = ids[aleatorio() % (unsigned) inseridas];
+        double t0 = agora_ns();
+        buscarReserva(motor, id, &encontrada);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("buscarReserva", amostras, p.consultas);
+
+    // Disponibilidade de um quarto e capacidade do hotel em períodos aleatórios
+    for (long i = 0; i < p.consultas; i++) {
+        int quarto = 1 + (int) (aleatorio() % (unsigned) p.quartos);
+        DataCompacta inicio = base + (DataCompacta) (aleatorio() % (unsigned) p.dias);
+        int dias = 1 + (int) (aleatorio() % 7);
+        double t0 = agora_ns();
+        isRoomAvailable(motor, quarto, inicio, dias);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("isRoomAvailable", amostras, p.consultas);
+
+    // Quartos livres de uma estadia, com os números de até 20 deles (como
+    // na interface); o custo cresce com quartos / 64 por dia
+    long consultas_livres = p.consultas / 10 > 0 ? p.consultas / 10 : 1;
+    int numeros_livres[20];
+    long soma_livres = 0;
+    for (long i = 0; i < consultas_livres; i++) {
+        DataCompacta inicio = base + (DataCompacta) (aleatorio() % (unsigned) p.dias);
+        int dias = 1 + (int) (aleatorio() % 7);
+        double t0 = agora_ns();
+        soma_livres += quartosLivres(motor, inicio, dias, numeros_livres, 20);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("quartosLivres", amostras, consultas_livres);
+
+    for (long i = 0; i < p.consultas; i++) {
+        DataCompacta inicio = base + (DataCompacta) (aleatorio() % (unsigned) p.dias);
+        int dias = 1 + (int) (aleatorio() % 7);
+        double t0 = agora_ns();
+        capacidadeDisponivel(motor, inicio, dias);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("capacidadeDisponivel", amostras, p.consultas);
+
+    // Listagem completa em ordem de data, lendo as pessoas de cada reserva
+    long soma_pessoas = 0;
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        travarLeituraReservas(motor);
+        for (No* no = primeiroNo(motor); no != NULL; no = proximoNo(no)) {
+            soma_pessoas += reservaDoNo(no)->num_pessoas;
+        }
+        destravarLeituraReservas(motor);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("listagem completa", amostras, p.repeticoes);
+
+    // A mesma soma lendo só a coluna de pessoas
+    long soma_colunas = 0;
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        travarLeituraReservas(motor);
+        ColunasReservas colunas = obterColunasReservas(motor);
+        for (long linha = 0; linha < colunas.linhas; linha++) {
+            soma_colunas += colunas.num_pessoas[linha];
+        }
+        destravarLeituraReservas(motor);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("soma em colunas", amostras, p.repeticoes);
+
+    // Receita do período inteiro com cada núcleo que o processador suporta,
+    // depois os agrupamentos por mês e por quarto
+    const char* padrao = nucleoAnalise();
+    const char* nucleos[] = {"escalar", "sse2", "avx2"};
+    double receita[3] = {0.0, 0.0, 0.0};
+    for (int n = 0; n < 3; n++) {
+        if (!definirNucleoAnalise(nucleos[n])) {
+            continue;
+        }
+        for (int i = 0; i < p.repeticoes; i++) {
+            double t0 = agora_ns();
+            receita[n] = totalizarReservas(motor, base, base + p.dias).receita;
+            amostras[i] = agora_ns() - t0;
+        }
+        char nome[40];
+        snprintf(nome, sizeof(nome), "totalizarReservas/%s", nucleos[n]);
+        relatar(nome, amostras, p.repeticoes);
+    }
+    definirNucleoAnalise(padrao);
+
+    int num_meses = p.dias / 28 + 2;
+    ResumoMes* meses = (ResumoMes*) alocar((size_t) num_meses * sizeof(ResumoMes));
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        resumirPorMes(motor, base, base + p.dias, meses, num_meses);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("resumirPorMes", amostras, p.repeticoes);
+    free(meses);
+
+    TotaisReservas* por_quarto = (TotaisReservas*) alocar((size_t) p.quartos * sizeof(TotaisReservas));
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        totalizarPorQuarto(motor, base, base + p.dias, por_quarto);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("totalizarPorQuarto", amostras, p.repeticoes);
+    free(por_quarto);
+
+    // Lote fora de ordem sobre um motor vazio: ordena pelas colunas e
+    // reconstrói a lista de saltos
+    Reserva* lote = (Reserva*) alocar((size_t) p.reservas * sizeof(Reserva));
+    for (int i = 0; i < p.repeticoes; i++) {
+        memcpy(lote, reservas, (size_t) p.reservas * sizeof(Reserva));
+        embaralhar(lote, p.reservas);
+        MotorReservas* vazio = criar_hotel(&p);
+        double t0 = agora_ns();
+        inserirReservasLote(vazio, lote, p.reservas, NULL);
+        amostras[i] = agora_ns() - t0;
+        liberarMotorReservas(vazio);
+    }
+    relatar("inserirReservasLote", amostras, p.repeticoes);
+
+    // Rede de H hotéis iguais: receita do grupo e busca de hóspede em todos
+    // os hotéis, pelo conjunto de threads da rede e hotel a hotel
+    RedeHoteis* rede = criarRedeHoteis(0);
+    for (int h = 0; h < p.hoteis; h++) {
+        memcpy(lote, reservas, (size_t) p.reservas * sizeof(Reserva));
+        MotorReservas* hotel = criar_hotel(&p);
+        inserirReservasLote(hotel, lote, p.reservas, NULL);
+        char codigo[REDE_CODIGO_MAX];
+        snprintf(codigo, sizeof(codigo), "H%d", h);
+        adicionarHotel(rede, codigo, hotel);
+    }
+    free(lote);
+
+    double receita_rede[2] = {0.0, 0.0};
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        receita_rede[0] = totalizarRede(rede, base, base + p.dias, NULL).receita;
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("totalizarRede", amostras, p.repeticoes);
+    for (int i = 0; i < p.repeticoes; i++) {
+        double t0 = agora_ns();
+        receita_rede[1] = 0.0;
+        for (int h = 0; h < p.hoteis; h++) {
+            receita_rede[1] += totalizarReservas(motorDoHotel(rede, h), base, base + p.dias).receita;
+        }
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("totalizarRede/serial", amostras, p.repeticoes);
+
+    long consultas_rede = p.consultas / 10 > 0 ? p.consultas / 10 : 1;
+    long encontradas_rede = 0;
+    for (long i = 0; i < consultas_rede; i++) {
+        char nome[40];
+        snprintf(nome, sizeof(nome), "Cliente %u", aleatorio() % (unsigned) p.reservas);
+        ReservaRede* encontradas;
+        double t0 = agora_ns();
+        encontradas_rede += buscarHospedeNaRede(rede, nome, 0, &encontradas);
+        amostras[i] = agora_ns() - t0;
+        free(encontradas);
+    }
+    relatar("buscarHospedeNaRede", amostras, consultas_rede);
+    for (long i = 0; i < consultas_rede; i++) {
+        char nome[40];
+        snprintf(nome, sizeof(nome), "Cliente %u", aleatorio() % (unsigned) p.reservas);
+        double t0 = agora_ns();
+        for (int h = 0; h < p.hoteis; h++) {
+            int* ids_hotel;
+            MotorReservas* hotel = motorDoHotel(rede, h);
+            int total = buscarReservasPorNome(hotel, nome, 0, &ids_hotel);
+            for (int k = 0; k < total; k++) {
+                Reserva r;
+                encontradas_rede += buscarReserva(hotel, ids_hotel[k], &r);
+            }
+            free(ids_hotel);
+        }
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("buscarHospedeNaRede/serial", amostras, consultas_rede);
+    liberarRedeHoteis(rede);
+
+    // Remoção de todas as reservas, em ordem aleatória
+    for (long i = inseridas - 1; i > 0; i--) {
+        long j = (long) (aleatorio() % (unsigned) (i + 1));
+        int temp = ids[i];
+        ids[i] = ids[j];
+        ids[j] = temp;
+    }
+    for (long i = 0; i < inseridas; i++) {
+        double t0 = agora_ns();
+        removerReserva(motor, ids[i]);
+        amostras[i] = agora_ns() - t0;
+    }
+    relatar("removerReserva", amostras, inseridas);
+
+    printf("\n(somas de verificação: %ld, %ld, %ld, %ld; receita: %.2f, %.2f, %.2f; rede: %.2f, %.2f)\n",
+           soma_pessoas, soma_colunas, soma_livres, encontradas_rede, receita[0], receita[1], receita[2],
+           receita_rede[0], receita_rede[1]);
+    liberarMotorReservas(motor);
+    free(ids);
+    free(amostras);
+    free(reservas);
+    return 0;
+}
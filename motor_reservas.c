@@ -0,0 +1,3825 @@
+// motor_reservas.c
+// Implementação do motor de reservas (ver motor_reservas.h)
+#include "motor_reservas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A lista é mantida ordenada por (inicio, reserva_id) como uma lista de
+// saltos: o nível 0 é o próprio encadeamento prox/ant e os níveis acima,
+// cada um com ~1/4 dos nós do nível anterior, aceleram a busca da posição.
+// Cada salto guarda também quantas posições avança (largura), o que permite
+// achar o n-ésimo nó e a posição de um nó em O(log N).
+#define NIVEIS_SALTO 12  // Suficiente para ~4^12 (16 milhões) de reservas
+
+struct No {
+    Reserva reserva;
+    long linha;                          // Linha da reserva na tabela em colunas
+    struct No* prox;
+    struct No* ant;
+    struct No* salto[NIVEIS_SALTO - 1];  // Sucessor nos níveis 1..NIVEIS_SALTO-1
+    int largura[NIVEIS_SALTO - 1];       // Posições avançadas por cada salto
+    int altura;                          // Quantos níveis contêm este nó
+};
+
+typedef struct {
+    No* cabeca[NIVEIS_SALTO];     // Primeiro nó de cada nível; cabeca[0] é a lista
+    int altura;                   // Níveis atualmente em uso
+    uint32_t semente;             // Estado do gerador de alturas
+    int largura[NIVEIS_SALTO];    // Posição do primeiro nó de cada nível
+    int tamanho;                  // Número de nós
+    No* cauda;                    // Último nó do nível 0
+} ListaSaltos;
+
+// Pool de nós: blocos de NOS_POR_BLOCO nós contíguos, com lista de livres
+#define NOS_POR_BLOCO 1024
+
+typedef struct BlocoNos {
+    struct BlocoNos* prox;
+    No nos[NOS_POR_BLOCO];
+} BlocoNos;
+
+typedef struct {
+    BlocoNos* blocos;        // O primeiro é o bloco atual
+    No* livres;              // Nós reciclados, encadeados por prox
+    size_t usados_no_bloco;  // Nós já entregues do bloco atual
+    size_t nos_vivos;
+    size_t num_blocos;
+} PoolNos;
+
+
+// Tabela das reservas em colunas: cada campo usado em varreduras fica num
+// vetor próprio e os nomes num heap de texto separado, para que ordenações,
+// somas e agregações leiam só as colunas de que precisam em vez de arrastar
+// o nome de 100 bytes de cada reserva pela cache. A linha de uma reserva não
+// muda enquanto ela existir; linhas liberadas por remoções são reaproveitadas.
+typedef struct {
+    int* reserva_id;          // 0 marca uma linha livre
+    int* quarto_id;
+    int* posicao_quarto;      // Posição do quarto no layout, -1 se não existe
+    DataCompacta* inicio;
+    int* num_diarias;
+    int* num_pessoas;
+    double* preco;
+    uint32_t* nome;           // Deslocamento do nome em 'nomes'
+    char* nomes;              // Heap dos nomes, cada um terminado em '\0'
+    size_t nomes_tamanho;
+    size_t nomes_capacidade;
+    size_t nomes_mortos;      // Bytes de nomes de linhas já removidas
+    long* livres;             // Pilha de linhas livres
+    long num_livres;
+    long linhas;              // Linhas em uso mais as livres
+    long capacidade;
+} TabelaColunas;
+
+// Índice hash (endereçamento aberto) das reservas por reserva_id
+#define INDICE_VAZIO 0        // reserva_id nunca é 0
+#define INDICE_REMOVIDO (-1)  // lápide deixada por removerReserva
+#define INDICE_CAPACIDADE_INICIAL 64
+
+typedef struct {
+    int chave;  // reserva_id, INDICE_VAZIO ou INDICE_REMOVIDO
+    No* no;
+} EntradaIndice;
+
+typedef struct {
+    EntradaIndice* entradas;
+    size_t capacidade;  // Sempre potência de 2
+    size_t ocupadas;    // Entradas com reserva
+    size_t removidas;   // Lápides
+} IndiceReservas;
+
+// Índice de ocupação por quarto: intervalos [inicio, fim) em dias absolutos,
+// ordenados por inicio. Os intervalos de um mesmo quarto não se sobrepõem,
+// pois toda inserção passa antes por isRoomAvailable.
+typedef struct {
+    DataCompacta inicio;  // Primeiro dia ocupado
+    DataCompacta fim;     // Dia seguinte ao último dia ocupado
+    int reserva_id;
+} Intervalo;
+
+typedef struct {
+    Intervalo* itens;
+    int tamanho;
+    int capacidade;
+} IntervalosQuarto;
+
+// Calendário de ocupação: para cada dia, o conjunto de quartos ocupados (um
+// bit por posição de quarto no layout, em 'palavras' palavras de 64 bits) e
+// os totais do dia. Cobre a janela de dias já usada por alguma reserva e
+// cresce conforme necessário; dias fora dela estão livres. Um bit ligado é
+// uma reserva confirmada ou uma reivindicação de reservarQuarto em andamento.
+// As palavras são atômicas para que reservarQuarto possa reivindicar um
+// quarto com compare-and-swap sob a trava de leitura; com a trava de escrita
+// são lidas e escritas diretamente.
+typedef struct {
+    _Atomic uint64_t* bits;     // Dia i em bits[i * palavras]
+    AgregadoDia* totais;        // totais[i] corresponde a primeiro_dia + i
+    DataCompacta primeiro_dia;
+    int num_dias;
+    int palavras;               // Palavras por dia, conforme o número de quartos
+} CalendarioOcupacao;
+
+// Layout do hotel: os quartos ordenados por número. A posição de um quarto
+// neste vetor é o seu índice interno, usado nos intervalos, no calendário e
+// na tabela em colunas; o número (quarto_id) é traduzido uma vez por
+// operação, por busca binária.
+typedef struct {
+    Quarto* quartos;
+    int num_quartos;
+    int capacidade_total;       // Limite de hóspedes por dia no hotel
+} TabelaQuartos;
+
+// Tarifas por pessoa por diária de cada tipo de quarto. A tarifa de um dia é
+// a da temporada que o cobre (ou a base do tipo) vezes o fator do dia da
+// semana. Na janela das temporadas as tarifas ficam em somas de prefixos por
+// blocos de TARIFA_BLOCO dias (parcial dentro do bloco mais o acumulado dos
+// blocos anteriores): o preço de uma estadia de qualquer tamanho sai de duas
+// leituras, e mudar uma temporada refaz só os blocos tocados e o acumulado
+// dos blocos seguintes. Fora da janela vale a base com o fator do dia da
+// semana, somada em O(7) pela contagem de cada dia da semana no período.
+#define TARIFA_BLOCO 64
+
+typedef struct {
+    double base;              // Tarifa fora das temporadas
+    double fator_semana[7];   // Multiplicador de cada dia da semana (0 = domingo)
+    double* temporada;        // Tarifa da temporada em cada dia da janela; 0 = base
+    double* parcial;          // Soma desde o início do bloco até o dia (exclusive)
+    double* acumulado;        // Soma antes de cada bloco; num_blocos + 1 itens
+} TarifasTipo;
+
+typedef struct {
+    TarifasTipo tipos[TIPOS_QUARTO_MAX];
+    DataCompacta primeiro_dia;  // Janela das temporadas
+    int num_dias;               // Múltiplo de TARIFA_BLOCO; 0 sem temporadas
+} TabelaTarifas;
+
+// Índice dos nomes dos clientes: árvore de prefixos (trie) sobre o nome
+// normalizado (minúsculas, sem acentos, espaços simples). Cada nó aponta
+// para o primeiro filho e para o próximo irmão; os nós ficam em um vetor e
+// se referenciam por posição. Nós esvaziados por remoções não são liberados.
+#define TRIE_NENHUM (-1)
+
+typedef struct {
+    int filho;          // Primeiro filho ou TRIE_NENHUM
+    int irmao;          // Próximo irmão ou TRIE_NENHUM
+    int* ids;           // Reservas cujo nome termina neste nó
+    int num_ids;
+    int capacidade_ids;
+    unsigned char letra;
+} NoTrie;
+
+typedef struct {
+    NoTrie* nos;        // nos[0] é a raiz
+    int tamanho;
+    int capacidade;
+} IndiceNomes;
+
+// Arquivo binário de reservas: cabeçalho seguido de registros de tamanho fixo,
+// na ordem da lista (por data). Inteiros em little-endian. A versão 1 tinha
+// o preço em float (perdia centavos acima de R$ 131.072,00); ela ainda é
+// lida e a próxima gravação já usa a versão 2.
+#define ARQUIVO_MAGICO 0x48565352u  // "RSVH"
+#define ARQUIVO_VERSAO 2
+#define ARQUIVO_VERSAO_FLOAT 1
+
+typedef struct {
+    uint32_t magico;
+    uint32_t versao;
+    uint32_t tamanho_registro;  // sizeof(RegistroReserva)
+    uint32_t proximo_id;        // motor->proximo_id no momento da gravação
+    uint64_t num_registros;
+    uint32_t checksum;          // Soma de verificação dos registros
+    uint32_t reservado;
+} CabecalhoArquivo;
+
+typedef struct {
+    int32_t reserva_id;
+    int32_t quarto_id;
+    int32_t inicio;             // DataCompacta
+    int32_t num_diarias;
+    int32_t num_pessoas;
+    double preco;
+    char nome_cliente[100];
+} RegistroReserva;
+
+// Registro da versão 1 do arquivo e do diário
+typedef struct {
+    int32_t reserva_id;
+    int32_t quarto_id;
+    int32_t inicio;
+    int32_t num_diarias;
+    int32_t num_pessoas;
+    float preco;
+    char nome_cliente[100];
+} RegistroReservaFloat;
+
+// Diário (write-ahead log) das inserções e remoções feitas desde a última
+// gravação de reservas.dat. Cada operação é escrita no arquivo na hora e as
+// sincronizações com o disco (fsync) são agrupadas em janelas de janela_ms.
+#define DIARIO_LIMITE_COMPACTACAO (8u << 20)  // Tamanho que dispara a compactação
+#define DIARIO_INSERCAO 3u
+#define DIARIO_REMOCAO 4u
+#define DIARIO_LOTE 5u             // Início de um lote: reserva_id = quantidade
+
+// Um lote é uma entrada DIARIO_LOTE seguida das suas DIARIO_INSERCAO; na
+// reprodução ele só é aplicado se todas as entradas estiverem íntegras.
+typedef struct {
+    uint32_t tipo;              // DIARIO_INSERCAO, DIARIO_REMOCAO ou DIARIO_LOTE
+    uint32_t checksum;          // Soma de verificação de 'registro'
+    RegistroReserva registro;   // Na remoção e no lote só reserva_id é usado
+} EntradaDiario;
+
+// Diário da versão 1 (preço em float). É reconhecido pelo tipo da primeira
+// entrada, reproduzido e, ao abrir o diário, substituído por um snapshot.
+#define DIARIO_INSERCAO_FLOAT 1u
+#define DIARIO_REMOCAO_FLOAT 2u
+
+typedef struct {
+    uint32_t tipo;
+    uint32_t checksum;
+    RegistroReservaFloat registro;
+} EntradaDiarioFloat;
+
+typedef struct {
+    pthread_mutex_t trava;       // Protege o arquivo e os contadores abaixo
+    FILE* arquivo;
+    char caminho[256];
+    char caminho_snapshot[256];  // Arquivo regravado na compactação
+    int janela_ms;
+    size_t pendentes;            // Entradas escritas e ainda não sincronizadas
+    long long primeiro_pendente_ms;
+    uint64_t tamanho;            // Bytes atualmente no diário
+    int converter;               // Diário da versão 1 reproduzido: regravar ao abrir
+    int falhou;                  // Escrita falhou e o arquivo não foi restaurado
+} Diario;
+
+// Importação e exportação em CSV: campos separados por vírgula, texto entre
+// aspas quando necessário (aspas internas duplicadas). As colunas seguem o
+// layout de Reserva: reserva_id,quarto_id,nome_cliente,data_inicio,
+// num_diarias,num_pessoas,preco. Na importação reserva_id é ignorado (a
+// reserva recebe um id novo) e preco é opcional.
+#define CSV_TAMANHO_BLOCO (64 * 1024)
+#define CSV_NUM_CAMPOS 7
+#define CSV_TAMANHO_CAMPO 100
+#define CSV_MAX_ERROS 20  // Erros detalhados na saída; os demais só são contados
+
+typedef struct {
+    char campos[CSV_NUM_CAMPOS][CSV_TAMANHO_CAMPO];
+    int tamanhos[CSV_NUM_CAMPOS];
+    int num_campos;     // Campos lidos, inclusive os que excedem CSV_NUM_CAMPOS
+    int truncada;       // Algum campo não coube em CSV_TAMANHO_CAMPO
+} LinhaCSV;
+
+typedef struct {
+    Reserva* reservas;  // Reservas válidas lidas até agora
+    long* linhas;       // Número da linha de cada uma, para as mensagens
+    long tamanho;
+    long capacidade;
+    long erros;
+} LoteCSV;
+
+// Contadores de reservarQuarto, atualizados sem trava
+typedef struct {
+    atomic_long tentativas;
+    atomic_long aceitas;
+    atomic_long conflitos;
+    atomic_long repeticoes;
+    atomic_long desfeitas;
+} ContadoresDisputa;
+
+// Estado completo de um hotel: todas as estruturas que antes eram variáveis
+// globais do programa.
+//
+// Concorrência: 'trava' é uma trava de leitores e escritor sobre todas as
+// estruturas. Consultas (busca, disponibilidade, totais, listagem) tomam a
+// trava de leitura e rodam em paralelo; alterações tomam a de escrita só
+// pelo tempo de ligar ou desligar os nós. Em reservarQuarto o quarto é
+// reivindicado sob a trava de leitura, ligando com compare-and-swap o bit do
+// quarto em cada dia do calendário: entre pedidos que disputam o mesmo quarto
+// e dias exatamente um liga todos os bits, e os demais falham sem esperar
+// por trava nenhuma. Só o vencedor chega à trava de escrita. O diário tem
+// trava própria, para que o fsync não bloqueie as consultas.
+struct MotorReservas {
+    pthread_rwlock_t trava;
+    ListaSaltos saltos;                              // Reservas ordenadas por data
+    IndiceReservas indice;                           // reserva_id -> nó
+    TabelaColunas tabela;
+    PoolNos pool;
+    TabelaQuartos quartos;                           // Layout do hotel
+    IntervalosQuarto* intervalos;                    // Indexado pela posição do quarto
+    CalendarioOcupacao calendario;
+    TabelaTarifas tarifas;
+    IndiceNomes nomes;
+    Diario diario;
+    ObservadorReservas observador;
+    void* dados_observador;
+    atomic_int proximo_id;  // Gerador de reserva_id
+    ContadoresDisputa disputa;
+};
+
+// Protótipos das Funções internas
+static No* pool_alocar_no(PoolNos* pool);
+static void pool_liberar_no(PoolNos* pool, No* no);
+static void pool_liberar_tudo(PoolNos* pool);
+static void indice_reservar(IndiceReservas* indice, size_t quantidade);
+static void indice_inserir(IndiceReservas* indice, int id, No* no);
+static No* indice_buscar(const IndiceReservas* indice, int id);
+static void indice_remover(IndiceReservas* indice, int id);
+static void indice_limpar(IndiceReservas* indice);
+static int compare_reserva_dates(const Reserva* a, const Reserva* b);
+static long tabela_inserir(TabelaColunas* tabela, const Reserva* reserva, int posicao_quarto);
+static void tabela_remover(TabelaColunas* tabela, long linha);
+static void tabela_limpar(TabelaColunas* tabela);
+static No* ordenar_lista(const TabelaColunas* tabela, No* head, long quantidade, No** cauda_final);
+static int saltos_altura_aleatoria(ListaSaltos* saltos);
+static void saltos_predecessores(ListaSaltos* saltos, const Reserva* chave, No* pred[NIVEIS_SALTO], int pos[NIVEIS_SALTO]);
+static int saltos_inserir(ListaSaltos* saltos, No* no);
+static int saltos_remover(ListaSaltos* saltos, No* no);
+static void saltos_reconstruir(ListaSaltos* saltos, No* cabeca);
+static No* saltos_no_na_posicao(ListaSaltos* saltos, int indice);
+static int saltos_posicao(ListaSaltos* saltos, const No* no);
+static int quarto_posicao_inicio(const IntervalosQuarto* quarto, DataCompacta inicio);
+static int quarto_posicao(const TabelaQuartos* quartos, int numero);
+static void quarto_adicionar_intervalo(MotorReservas* motor, int posicao, DataCompacta inicio, int dias, int reserva_id);
+static void quarto_remover_intervalo(MotorReservas* motor, int posicao, DataCompacta inicio, int reserva_id);
+static void calendario_marcar(CalendarioOcupacao* calendario, int posicao, DataCompacta inicio, int dias, int ocupado);
+static void calendario_somar_reserva(CalendarioOcupacao* calendario, const Reserva* reserva, int sinal);
+static void calendario_limpar(CalendarioOcupacao* calendario);
+static void tarifas_iniciar(TabelaTarifas* tarifas);
+static double tarifas_somar(const TabelaTarifas* tarifas, int tipo, DataCompacta inicio, int dias);
+static double preco_reserva(const MotorReservas* motor, const Reserva* reserva);
+static void tarifas_limpar(TabelaTarifas* tarifas);
+static void nomes_inserir(IndiceNomes* indice, const char* nome, int reserva_id);
+static void nomes_remover(IndiceNomes* indice, const char* nome, int reserva_id);
+static int nomes_buscar(const IndiceNomes* indice, const char* nome, int prefixo, int** ids);
+static void nomes_limpar(IndiceNomes* indice);
+static No* inserirReservaPronta(MotorReservas* motor, Reserva reserva);
+static int diario_registrar(MotorReservas* motor, uint32_t tipo, const Reserva* reserva);
+static int diario_registrar_lote(MotorReservas* motor, const Reserva* lote, long n);
+static void diario_compactar_se_cheio(MotorReservas* motor);
+static int diario_regravar(MotorReservas* motor);
+
+// Implementação das Funções
+
+// Função para obter um nó do pool, reaproveitando nós liberados
+static No* pool_alocar_no(PoolNos* pool) {
+    No* no;
+    if (pool->livres != NULL) {
+        no = pool->livres;
+        pool->livres = no->prox;
+    } else {
+        if (pool->blocos == NULL || pool->usados_no_bloco == NOS_POR_BLOCO) {
+            BlocoNos* bloco = (BlocoNos*) malloc(sizeof(BlocoNos));
+            if (bloco == NULL) {
+                printf("Erro de alocação de memória!\n");
+                exit(1);
+            }
+            bloco->prox = pool->blocos;
+            pool->blocos = bloco;
+            pool->usados_no_bloco = 0;
+            pool->num_blocos++;
+        }
+        no = &pool->blocos->nos[pool->usados_no_bloco++];
+    }
+    pool->nos_vivos++;
+    return no;
+}
+
+// Função para devolver um nó ao pool
+static void pool_liberar_no(PoolNos* pool, No* no) {
+    no->prox = pool->livres;
+    pool->livres = no;
+    pool->nos_vivos--;
+}
+
+// Função para devolver todos os blocos ao sistema de uma só vez
+static void pool_liberar_tudo(PoolNos* pool) {
+    BlocoNos* bloco = pool->blocos;
+    while (bloco != NULL) {
+        BlocoNos* prox = bloco->prox;
+        free(bloco);
+        bloco = prox;
+    }
+    pool->blocos = NULL;
+    pool->livres = NULL;
+    pool->usados_no_bloco = 0;
+    pool->nos_vivos = 0;
+    pool->num_blocos = 0;
+}
+
+EstatisticasPool obterEstatisticasPool(MotorReservas* motor) {
+    EstatisticasPool estatisticas;
+    pthread_rwlock_rdlock(&motor->trava);
+    estatisticas.nos_vivos = motor->pool.nos_vivos;
+    estatisticas.blocos = motor->pool.num_blocos;
+    estatisticas.nos_livres = motor->pool.num_blocos * NOS_POR_BLOCO - motor->pool.nos_vivos;
+    estatisticas.bytes = motor->pool.num_blocos * sizeof(BlocoNos);
+    pthread_rwlock_unlock(&motor->trava);
+    return estatisticas;
+}
+
+// Função de espalhamento para reserva_id (finalizador do MurmurHash3)
+static size_t indice_hash(int id) {
+    uint32_t h = (uint32_t)id;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Função para realocar a tabela, descartando as lápides
+static void indice_redimensionar(IndiceReservas* indice, size_t nova_capacidade) {
+    EntradaIndice* antigas = indice->entradas;
+    size_t capacidade_antiga = indice->capacidade;
+
+    indice->entradas = (EntradaIndice*) calloc(nova_capacidade, sizeof(EntradaIndice));
+    if (indice->entradas == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    indice->capacidade = nova_capacidade;
+    indice->ocupadas = 0;
+    indice->removidas = 0;
+
+    for (size_t i = 0; i < capacidade_antiga; i++) {
+        if (antigas[i].chave > 0) {
+            indice_inserir(indice, antigas[i].chave, antigas[i].no);
+        }
+    }
+    free(antigas);
+}
+
+// Função para dimensionar a tabela de uma vez antes de uma carga em lote de
+// 'quantidade' reservas além das que ela já tem
+static void indice_reservar(IndiceReservas* indice, size_t quantidade) {
+    size_t nova_capacidade = indice->capacidade ? indice->capacidade : INDICE_CAPACIDADE_INICIAL;
+    while ((indice->ocupadas + quantidade) * 2 > nova_capacidade / 2) {
+        nova_capacidade *= 2;
+    }
+    if (nova_capacidade != indice->capacidade) {
+        indice_redimensionar(indice, nova_capacidade);
+    }
+}
+
+static void indice_inserir(IndiceReservas* indice, int id, No* no) {
+    // Mantém a ocupação (incluindo lápides) abaixo de 50%
+    if ((indice->ocupadas + indice->removidas + 1) * 2 > indice->capacidade) {
+        size_t nova_capacidade = indice->capacidade ? indice->capacidade : INDICE_CAPACIDADE_INICIAL;
+        while ((indice->ocupadas + 1) * 2 > nova_capacidade / 2) {
+            nova_capacidade *= 2;
+        }
+        indice_redimensionar(indice, nova_capacidade);
+    }
+
+    size_t mascara = indice->capacidade - 1;
+    size_t i = indice_hash(id) & mascara;
+    EntradaIndice* lapide = NULL;
+    while (indice->entradas[i].chave != INDICE_VAZIO) {
+        if (indice->entradas[i].chave == id) {
+            indice->entradas[i].no = no;
+            return;
+        }
+        if (indice->entradas[i].chave == INDICE_REMOVIDO && lapide == NULL) {
+            lapide = &indice->entradas[i];
+        }
+        i = (i + 1) & mascara;
+    }
+
+    if (lapide != NULL) {
+        indice->removidas--;
+    } else {
+        lapide = &indice->entradas[i];
+    }
+    lapide->chave = id;
+    lapide->no = no;
+    indice->ocupadas++;
+}
+
+static No* indice_buscar(const IndiceReservas* indice, int id) {
+    if (indice->capacidade == 0 || id <= 0) {
+        return NULL;
+    }
+    size_t mascara = indice->capacidade - 1;
+    size_t i = indice_hash(id) & mascara;
+    while (indice->entradas[i].chave != INDICE_VAZIO) {
+        if (indice->entradas[i].chave == id) {
+            return indice->entradas[i].no;
+        }
+        i = (i + 1) & mascara;
+    }
+    return NULL;
+}
+
+static void indice_remover(IndiceReservas* indice, int id) {
+    if (indice->capacidade == 0 || id <= 0) {
+        return;
+    }
+    size_t mascara = indice->capacidade - 1;
+    size_t i = indice_hash(id) & mascara;
+    while (indice->entradas[i].chave != INDICE_VAZIO) {
+        if (indice->entradas[i].chave == id) {
+            indice->entradas[i].chave = INDICE_REMOVIDO;
+            indice->entradas[i].no = NULL;
+            indice->ocupadas--;
+            indice->removidas++;
+            return;
+        }
+        i = (i + 1) & mascara;
+    }
+}
+
+static void indice_limpar(IndiceReservas* indice) {
+    free(indice->entradas);
+    indice->entradas = NULL;
+    indice->capacidade = 0;
+    indice->ocupadas = 0;
+    indice->removidas = 0;
+}
+
+int isAnoBissexto(int ano) {
+    return (ano % 4 == 0 && ano % 100 != 0) || (ano % 400 == 0);
+}
+
+int diasNoMes(int mes, int ano) {
+    switch (mes) {
+        case 1: case 3: case 5: case 7: case 8: case 10: case 12: return 31;
+        case 4: case 6: case 9: case 11: return 30;
+        case 2: return isAnoBissexto(ano) ? 29 : 28;
+        default: return 0; // Mês inválido
+    }
+}
+
+// Função para converter uma data do calendário em dias desde 01/01/1970
+DataCompacta data_para_dias(int dia, int mes, int ano) {
+    static const int dias_antes_do_mes[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    int anos_anteriores = ano - 1;
+    DataCompacta bissextos = anos_anteriores / 4 - anos_anteriores / 100 + anos_anteriores / 400
+                             - (1969 / 4 - 1969 / 100 + 1969 / 400);
+    DataCompacta dias = (DataCompacta)(ano - 1970) * 365 + bissextos + dias_antes_do_mes[mes - 1] + (dia - 1);
+    if (mes > 2 && isAnoBissexto(ano)) {
+        dias++;
+    }
+    return dias;
+}
+
+// Função para converter dias desde 01/01/1970 de volta em dia, mês e ano
+void dias_para_data(DataCompacta dias, int* dia, int* mes, int* ano) {
+    // Estimativa pelo ano médio gregoriano, corrigida em no máximo um ano
+    int a = 1970 + (int)(((int64_t)dias * 400) / 146097);
+    if (dias < 0) {
+        a--;
+    }
+    while (data_para_dias(1, 1, a + 1) <= dias) {
+        a++;
+    }
+    while (data_para_dias(1, 1, a) > dias) {
+        a--;
+    }
+
+    int restante = dias - data_para_dias(1, 1, a);
+    int m = 1;
+    while (restante >= diasNoMes(m, a)) {
+        restante -= diasNoMes(m, a);
+        m++;
+    }
+
+    *dia = restante + 1;
+    *mes = m;
+    *ano = a;
+}
+
+// Função para ler um campo numérico de largura fixa; retorna -1 se não for numérico
+static int ler_digitos(const char* str, int largura) {
+    int valor = 0;
+    for (int i = 0; i < largura; i++) {
+        if (str[i] < '0' || str[i] > '9') {
+            return -1;
+        }
+        valor = valor * 10 + (str[i] - '0');
+    }
+    return valor;
+}
+
+// Função para converter "DD/MM/AAAA" em DataCompacta, sem sscanf nem mktime.
+// Só aceita o formato completo, com zeros à esquerda ("01/02/2025", não
+// "1/2/2025"), e nada depois do ano.
+DataCompacta parse_data_compacta(const char* data_str) {
+    if (strnlen(data_str, 11) != 10 || data_str[2] != '/' || data_str[5] != '/') {
+        return DATA_INVALIDA;
+    }
+    int dia = ler_digitos(data_str, 2);
+    int mes = ler_digitos(data_str + 3, 2);
+    int ano = ler_digitos(data_str + 6, 4);
+    if (dia < 1 || mes < 1 || mes > 12 || ano < 0 || dia > diasNoMes(mes, ano)) {
+        return DATA_INVALIDA;
+    }
+    return data_para_dias(dia, mes, ano);
+}
+
+// Função para formatar uma DataCompacta como "DD/MM/AAAA" (data_str com 11 bytes)
+void formatar_data_compacta(DataCompacta dias, char* data_str) {
+    int dia, mes, ano;
+    dias_para_data(dias, &dia, &mes, &ano);
+    data_str[0] = '0' + dia / 10;
+    data_str[1] = '0' + dia % 10;
+    data_str[2] = '/';
+    data_str[3] = '0' + mes / 10;
+    data_str[4] = '0' + mes % 10;
+    data_str[5] = '/';
+    data_str[6] = '0' + ano / 1000 % 10;
+    data_str[7] = '0' + ano / 100 % 10;
+    data_str[8] = '0' + ano / 10 % 10;
+    data_str[9] = '0' + ano % 10;
+    data_str[10] = '\0';
+}
+
+// Função para obter a data local de hoje como DataCompacta (segura entre
+// threads: localtime usaria um buffer estático compartilhado)
+DataCompacta data_hoje() {
+    time_t agora = time(NULL);
+    struct tm hoje_tm;
+#ifdef _WIN32
+    localtime_s(&hoje_tm, &agora);
+#else
+    localtime_r(&agora, &hoje_tm);
+#endif
+    return data_para_dias(hoje_tm.tm_mday, hoje_tm.tm_mon + 1, hoje_tm.tm_year + 1900);
+}
+
+// Função para verificar se dois períodos de reserva se sobrepõem
+int ranges_overlap(DataCompacta start1, int days1, DataCompacta start2, int days2) {
+    // Períodos [start, start + days) se sobrepõem se cada um começa antes do fim do outro
+    return start1 < start2 + days2 && start2 < start1 + days1;
+}
+
+// Função para conferir se a data existe e está entre 1900 e 2100, passada
+// ou futura
+static int data_no_calendario(const char* data_str) {
+    if (parse_data_compacta(data_str) == DATA_INVALIDA) return 0;
+
+    int ano = ler_digitos(data_str + 6, 4);
+    return ano >= 1900 && ano <= 2100;
+}
+
+int verificarDataValida(const char* data_str) {
+    if (!data_no_calendario(data_str)) return 0;
+
+    // A data deve ser hoje ou uma data futura
+    if (parse_data_compacta(data_str) < data_hoje()) return 0;
+
+    return 1;
+}
+
+// Função para comparar reservas por data e, em caso de empate, por reserva_id
+static int compare_reserva_dates(const Reserva* a, const Reserva* b) {
+    if (a->inicio != b->inicio)
+        return a->inicio < b->inicio ? -1 : 1;
+    if (a->reserva_id != b->reserva_id)
+        return a->reserva_id < b->reserva_id ? -1 : 1;
+    return 0;
+}
+
+// Função para garantir espaço para 'minimo' linhas em todas as colunas
+static void tabela_reservar(TabelaColunas* tabela, long minimo) {
+    if (minimo <= tabela->capacidade) {
+        return;
+    }
+    long capacidade = tabela->capacidade ? tabela->capacidade : 1024;
+    while (capacidade < minimo) {
+        capacidade *= 2;
+    }
+    size_t n = (size_t) capacidade;
+    int* reserva_id = (int*) realloc(tabela->reserva_id, n * sizeof(int));
+    if (reserva_id != NULL) tabela->reserva_id = reserva_id;
+    int* quarto_id = (int*) realloc(tabela->quarto_id, n * sizeof(int));
+    if (quarto_id != NULL) tabela->quarto_id = quarto_id;
+    int* posicao_quarto = (int*) realloc(tabela->posicao_quarto, n * sizeof(int));
+    if (posicao_quarto != NULL) tabela->posicao_quarto = posicao_quarto;
+    DataCompacta* inicio = (DataCompacta*) realloc(tabela->inicio, n * sizeof(DataCompacta));
+    if (inicio != NULL) tabela->inicio = inicio;
+    int* num_diarias = (int*) realloc(tabela->num_diarias, n * sizeof(int));
+    if (num_diarias != NULL) tabela->num_diarias = num_diarias;
+    int* num_pessoas = (int*) realloc(tabela->num_pessoas, n * sizeof(int));
+    if (num_pessoas != NULL) tabela->num_pessoas = num_pessoas;
+    double* preco = (double*) realloc(tabela->preco, n * sizeof(double));
+    if (preco != NULL) tabela->preco = preco;
+    uint32_t* nome = (uint32_t*) realloc(tabela->nome, n * sizeof(uint32_t));
+    if (nome != NULL) tabela->nome = nome;
+    long* livres = (long*) realloc(tabela->livres, n * sizeof(long));
+    if (livres != NULL) tabela->livres = livres;
+    if (reserva_id == NULL || quarto_id == NULL || posicao_quarto == NULL || inicio == NULL || num_diarias == NULL ||
+        num_pessoas == NULL || preco == NULL || nome == NULL || livres == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    tabela->capacidade = capacidade;
+}
+
+// Função para refazer o heap de nomes sem os nomes das linhas removidas
+static void tabela_compactar_nomes(TabelaColunas* tabela) {
+    char* nomes = (char*) malloc(tabela->nomes_capacidade);
+    if (nomes == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    size_t tamanho = 0;
+    for (long linha = 0; linha < tabela->linhas; linha++) {
+        if (tabela->reserva_id[linha] != 0) {
+            const char* nome = tabela->nomes + tabela->nome[linha];
+            size_t n = strlen(nome) + 1;
+            memcpy(nomes + tamanho, nome, n);
+            tabela->nome[linha] = (uint32_t) tamanho;
+            tamanho += n;
+        }
+    }
+    free(tabela->nomes);
+    tabela->nomes = nomes;
+    tabela->nomes_tamanho = tamanho;
+    tabela->nomes_mortos = 0;
+}
+
+// Função para gravar uma reserva numa linha da tabela (uma livre, se houver).
+// Retorna a linha.
+static long tabela_inserir(TabelaColunas* tabela, const Reserva* reserva, int posicao_quarto) {
+    long linha;
+    if (tabela->num_livres > 0) {
+        linha = tabela->livres[--tabela->num_livres];
+    } else {
+        tabela_reservar(tabela, tabela->linhas + 1);
+        linha = tabela->linhas++;
+    }
+
+    size_t n = strlen(reserva->nome_cliente) + 1;
+    if (tabela->nomes_tamanho + n > tabela->nomes_capacidade) {
+        size_t capacidade = tabela->nomes_capacidade ? tabela->nomes_capacidade : 16384;
+        while (capacidade < tabela->nomes_tamanho + n) {
+            capacidade *= 2;
+        }
+        char* nomes = (char*) realloc(tabela->nomes, capacidade);
+        if (nomes == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        tabela->nomes = nomes;
+        tabela->nomes_capacidade = capacidade;
+    }
+    memcpy(tabela->nomes + tabela->nomes_tamanho, reserva->nome_cliente, n);
+
+    tabela->reserva_id[linha] = reserva->reserva_id;
+    tabela->quarto_id[linha] = reserva->quarto_id;
+    tabela->posicao_quarto[linha] = posicao_quarto;
+    tabela->inicio[linha] = reserva->inicio;
+    tabela->num_diarias[linha] = reserva->num_diarias;
+    tabela->num_pessoas[linha] = reserva->num_pessoas;
+    tabela->preco[linha] = reserva->preco;
+    tabela->nome[linha] = (uint32_t) tabela->nomes_tamanho;
+    tabela->nomes_tamanho += n;
+    return linha;
+}
+
+// Função para liberar uma linha; o heap de nomes é compactado quando mais
+// da metade dele pertence a linhas removidas
+static void tabela_remover(TabelaColunas* tabela, long linha) {
+    tabela->nomes_mortos += strlen(tabela->nomes + tabela->nome[linha]) + 1;
+    tabela->reserva_id[linha] = 0;
+    tabela->inicio[linha] = DATA_INVALIDA;
+    tabela->num_pessoas[linha] = 0;
+    tabela->num_diarias[linha] = 0;
+    tabela->preco[linha] = 0.0;
+    tabela->livres[tabela->num_livres++] = linha;
+    if (tabela->nomes_mortos > tabela->nomes_tamanho / 2) {
+        tabela_compactar_nomes(tabela);
+    }
+}
+
+static void tabela_limpar(TabelaColunas* tabela) {
+    free(tabela->reserva_id);
+    free(tabela->quarto_id);
+    free(tabela->posicao_quarto);
+    free(tabela->inicio);
+    free(tabela->num_diarias);
+    free(tabela->num_pessoas);
+    free(tabela->preco);
+    free(tabela->nome);
+    free(tabela->nomes);
+    free(tabela->livres);
+    memset(tabela, 0, sizeof(*tabela));
+}
+
+// Chave de ordenação de uma linha: (inicio, reserva_id) num único inteiro
+// sem sinal, que compara na mesma ordem que compare_reserva_dates
+typedef struct {
+    uint64_t chave;
+    No* no;
+} ChaveOrdenacao;
+
+static int comparar_chaves(const void* a, const void* b) {
+    uint64_t x = ((const ChaveOrdenacao*) a)->chave;
+    uint64_t y = ((const ChaveOrdenacao*) b)->chave;
+    return (x > y) - (x < y);
+}
+
+// Função para ordenar por data uma lista de 'quantidade' nós montada fora da
+// lista do motor. As chaves vêm das colunas inicio e reserva_id da tabela e
+// são ordenadas num vetor contíguo; a lista é percorrida só para colher os
+// nós e para religá-los, em vez de uma vez por passada de um merge sort.
+// Retorna a nova cabeça e o último nó em *cauda_final.
+static No* ordenar_lista(const TabelaColunas* tabela, No* head, long quantidade, No** cauda_final) {
+    *cauda_final = head;
+    if (!head || !head->prox || quantidade < 2)
+        return head;
+
+    ChaveOrdenacao* chaves = (ChaveOrdenacao*) malloc((size_t) quantidade * sizeof(ChaveOrdenacao));
+    if (chaves == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    long n = 0;
+    int ordenada = 1;
+    No* ultimo = head;
+    for (No* no = head; no != NULL && n < quantidade; no = no->prox, n++) {
+        ultimo = no;
+        long linha = no->linha;
+        chaves[n].chave = ((uint64_t) ((uint32_t) tabela->inicio[linha] ^ 0x80000000u) << 32) |
+                          (uint32_t) tabela->reserva_id[linha];
+        chaves[n].no = no;
+        if (n > 0 && chaves[n].chave < chaves[n - 1].chave) {
+            ordenada = 0;
+        }
+    }
+
+    // Lista já ordenada (como a de um arquivo gravado pelo motor): nada a fazer
+    if (!ordenada) {
+        qsort(chaves, (size_t) n, sizeof(ChaveOrdenacao), comparar_chaves);
+        head = chaves[0].no;
+        head->ant = NULL;
+        ultimo = head;
+        for (long i = 1; i < n; i++) {
+            ultimo->prox = chaves[i].no;
+            chaves[i].no->ant = ultimo;
+            ultimo = chaves[i].no;
+        }
+        ultimo->prox = NULL;
+    }
+    *cauda_final = ultimo;
+    free(chaves);
+    return head;
+}
+
+// Função para obter o sucessor de um nó em um nível da lista de saltos;
+// 'no' NULL representa a cabeça do nível
+static No* saltos_seguinte(const ListaSaltos* saltos, const No* no, int nivel) {
+    if (no == NULL)
+        return saltos->cabeca[nivel];
+    return nivel == 0 ? no->prox : no->salto[nivel - 1];
+}
+
+static void saltos_definir_seguinte(ListaSaltos* saltos, No* no, int nivel, No* seguinte) {
+    if (no == NULL)
+        saltos->cabeca[nivel] = seguinte;
+    else if (nivel == 0)
+        no->prox = seguinte;
+    else
+        no->salto[nivel - 1] = seguinte;
+}
+
+// Função para obter quantas posições o salto de um nó avança em um nível
+static int saltos_largura(const ListaSaltos* saltos, const No* no, int nivel) {
+    if (nivel == 0)
+        return 1;
+    return no == NULL ? saltos->largura[nivel] : no->largura[nivel - 1];
+}
+
+static void saltos_definir_largura(ListaSaltos* saltos, No* no, int nivel, int largura) {
+    if (nivel == 0)
+        return;
+    if (no == NULL)
+        saltos->largura[nivel] = largura;
+    else
+        no->largura[nivel - 1] = largura;
+}
+
+// Função para sortear a altura de um novo nó (probabilidade 1/4 por nível)
+static int saltos_altura_aleatoria(ListaSaltos* saltos) {
+    uint32_t x = saltos->semente;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    saltos->semente = x;
+
+    int altura = 1;
+    while (altura < NIVEIS_SALTO && (x & 3) == 0) {
+        altura++;
+        x >>= 2;
+    }
+    return altura;
+}
+
+// Função para encontrar, em cada nível, o último nó anterior a 'chave' e sua
+// posição (1 para o primeiro nó, 0 para a cabeça)
+static void saltos_predecessores(ListaSaltos* saltos, const Reserva* chave, No* pred[NIVEIS_SALTO], int pos[NIVEIS_SALTO]) {
+    No* x = NULL;
+    int posicao = 0;
+    for (int nivel = saltos->altura - 1; nivel >= 0; nivel--) {
+        No* seguinte = saltos_seguinte(saltos, x, nivel);
+        while (seguinte && compare_reserva_dates(&seguinte->reserva, chave) < 0) {
+            posicao += saltos_largura(saltos, x, nivel);
+            x = seguinte;
+            seguinte = saltos_seguinte(saltos, x, nivel);
+        }
+        pred[nivel] = x;
+        pos[nivel] = posicao;
+    }
+}
+
+// Função para inserir um nó na posição ordenada em O(log N); retorna a posição
+static int saltos_inserir(ListaSaltos* saltos, No* no) {
+    No* pred[NIVEIS_SALTO];
+    int pos[NIVEIS_SALTO];
+    no->altura = saltos_altura_aleatoria(saltos);
+    while (saltos->altura < no->altura) {
+        // Um nível novo começa vazio: o salto da cabeça vai até o fim
+        saltos->largura[saltos->altura] = saltos->tamanho + 1;
+        saltos->cabeca[saltos->altura++] = NULL;
+    }
+    saltos_predecessores(saltos, &no->reserva, pred, pos);
+    int posicao = pos[0] + 1;
+
+    for (int nivel = 0; nivel < no->altura; nivel++) {
+        saltos_definir_seguinte(saltos, no, nivel, saltos_seguinte(saltos, pred[nivel], nivel));
+        saltos_definir_seguinte(saltos, pred[nivel], nivel, no);
+
+        int largura_pred = saltos_largura(saltos, pred[nivel], nivel);
+        saltos_definir_largura(saltos, no, nivel, largura_pred - (posicao - pos[nivel]) + 1);
+        saltos_definir_largura(saltos, pred[nivel], nivel, posicao - pos[nivel]);
+    }
+    for (int nivel = no->altura; nivel < saltos->altura; nivel++) {
+        saltos_definir_largura(saltos, pred[nivel], nivel, saltos_largura(saltos, pred[nivel], nivel) + 1);
+    }
+    saltos->tamanho++;
+
+    no->ant = pred[0];
+    if (no->prox != NULL) {
+        no->prox->ant = no;
+    } else {
+        saltos->cauda = no;
+    }
+    return pos[0];
+}
+
+// Função para retirar um nó da lista de saltos em O(log N); retorna a posição que ocupava
+static int saltos_remover(ListaSaltos* saltos, No* no) {
+    No* pred[NIVEIS_SALTO];
+    int pos[NIVEIS_SALTO];
+    saltos_predecessores(saltos, &no->reserva, pred, pos);
+
+    for (int nivel = 0; nivel < no->altura; nivel++) {
+        saltos_definir_seguinte(saltos, pred[nivel], nivel, saltos_seguinte(saltos, no, nivel));
+        saltos_definir_largura(saltos, pred[nivel], nivel,
+                               saltos_largura(saltos, pred[nivel], nivel) + saltos_largura(saltos, no, nivel) - 1);
+    }
+    for (int nivel = no->altura; nivel < saltos->altura; nivel++) {
+        saltos_definir_largura(saltos, pred[nivel], nivel, saltos_largura(saltos, pred[nivel], nivel) - 1);
+    }
+    saltos->tamanho--;
+
+    if (no->prox != NULL) {
+        no->prox->ant = no->ant;
+    } else {
+        saltos->cauda = no->ant;
+    }
+
+    while (saltos->altura > 1 && saltos->cabeca[saltos->altura - 1] == NULL) {
+        saltos->altura--;
+    }
+    return pos[0];
+}
+
+// Função para refazer os níveis superiores a partir de uma lista já ordenada
+// no nível 0, em O(N); usada após cargas em lote
+static void saltos_reconstruir(ListaSaltos* saltos, No* cabeca) {
+    No* ultimo[NIVEIS_SALTO] = {NULL};
+    int posicao_ultimo[NIVEIS_SALTO] = {0};
+    for (int nivel = 0; nivel < NIVEIS_SALTO; nivel++) {
+        saltos->cabeca[nivel] = NULL;
+    }
+    saltos->cabeca[0] = cabeca;
+    saltos->altura = 1;
+    saltos->cauda = NULL;
+
+    int posicao = 0;
+    for (No* no = cabeca; no != NULL; no = no->prox) {
+        posicao++;
+        no->altura = saltos_altura_aleatoria(saltos);
+        if (no->altura > saltos->altura) {
+            saltos->altura = no->altura;
+        }
+        for (int nivel = 1; nivel < no->altura; nivel++) {
+            saltos_definir_seguinte(saltos, ultimo[nivel], nivel, no);
+            saltos_definir_largura(saltos, ultimo[nivel], nivel, posicao - posicao_ultimo[nivel]);
+            no->salto[nivel - 1] = NULL;
+            ultimo[nivel] = no;
+            posicao_ultimo[nivel] = posicao;
+        }
+        saltos->cauda = no;
+    }
+
+    // O último salto de cada nível vai até o fim da lista
+    saltos->tamanho = posicao;
+    for (int nivel = 1; nivel < saltos->altura; nivel++) {
+        saltos_definir_largura(saltos, ultimo[nivel], nivel, posicao + 1 - posicao_ultimo[nivel]);
+    }
+}
+
+// Função para obter o nó na posição 'indice' (a partir de 0) em O(log N)
+static No* saltos_no_na_posicao(ListaSaltos* saltos, int indice) {
+    if (indice < 0 || indice >= saltos->tamanho) {
+        return NULL;
+    }
+    int alvo = indice + 1;
+    int posicao = 0;
+    No* x = NULL;
+    for (int nivel = saltos->altura - 1; nivel >= 0; nivel--) {
+        while (saltos_seguinte(saltos, x, nivel) && posicao + saltos_largura(saltos, x, nivel) <= alvo) {
+            posicao += saltos_largura(saltos, x, nivel);
+            x = saltos_seguinte(saltos, x, nivel);
+        }
+        if (posicao == alvo) {
+            break;
+        }
+    }
+    return x;
+}
+
+// Função para obter a posição (a partir de 0) de um nó da lista em O(log N)
+static int saltos_posicao(ListaSaltos* saltos, const No* no) {
+    No* pred[NIVEIS_SALTO];
+    int pos[NIVEIS_SALTO];
+    saltos_predecessores(saltos, &no->reserva, pred, pos);
+    return pos[0];
+}
+
+// Função para encontrar o primeiro intervalo do quarto com inicio >= 'inicio'
+static int quarto_posicao_inicio(const IntervalosQuarto* quarto, DataCompacta inicio) {
+    int baixo = 0;
+    int alto = quarto->tamanho;
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (quarto->itens[meio].inicio < inicio) {
+            baixo = meio + 1;
+        } else {
+            alto = meio;
+        }
+    }
+    return baixo;
+}
+
+// Função para encontrar a posição do quarto no layout, por busca binária
+// sobre os números; retorna -1 se o hotel não tem esse quarto
+static int quarto_posicao(const TabelaQuartos* quartos, int numero) {
+    int baixo = 0;
+    int alto = quartos->num_quartos - 1;
+    while (baixo <= alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        if (quartos->quartos[meio].numero == numero) {
+            return meio;
+        } else if (quartos->quartos[meio].numero < numero) {
+            baixo = meio + 1;
+        } else {
+            alto = meio - 1;
+        }
+    }
+    return -1;
+}
+
+static void quarto_adicionar_intervalo(MotorReservas* motor, int posicao, DataCompacta inicio, int dias, int reserva_id) {
+    if (posicao < 0) {
+        return;
+    }
+    IntervalosQuarto* quarto = &motor->intervalos[posicao];
+    if (quarto->tamanho == quarto->capacidade) {
+        int nova_capacidade = quarto->capacidade ? quarto->capacidade * 2 : 8;
+        Intervalo* itens = (Intervalo*) realloc(quarto->itens, nova_capacidade * sizeof(Intervalo));
+        if (itens == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        quarto->itens = itens;
+        quarto->capacidade = nova_capacidade;
+    }
+
+    int pos = quarto_posicao_inicio(quarto, inicio);
+    memmove(&quarto->itens[pos + 1], &quarto->itens[pos], (quarto->tamanho - pos) * sizeof(Intervalo));
+    quarto->itens[pos].inicio = inicio;
+    quarto->itens[pos].fim = inicio + dias;
+    quarto->itens[pos].reserva_id = reserva_id;
+    quarto->tamanho++;
+    calendario_marcar(&motor->calendario, posicao, inicio, dias, 1);
+}
+
+static void quarto_remover_intervalo(MotorReservas* motor, int posicao, DataCompacta inicio, int reserva_id) {
+    if (posicao < 0) {
+        return;
+    }
+    IntervalosQuarto* quarto = &motor->intervalos[posicao];
+    for (int pos = quarto_posicao_inicio(quarto, inicio);
+         pos < quarto->tamanho && quarto->itens[pos].inicio == inicio; pos++) {
+        if (quarto->itens[pos].reserva_id == reserva_id) {
+            calendario_marcar(&motor->calendario, posicao, inicio, quarto->itens[pos].fim - inicio, 0);
+            memmove(&quarto->itens[pos], &quarto->itens[pos + 1], (quarto->tamanho - pos - 1) * sizeof(Intervalo));
+            quarto->tamanho--;
+            return;
+        }
+    }
+}
+
+// Função para ampliar a janela do calendário até cobrir [inicio, inicio + dias)
+static void calendario_garantir(CalendarioOcupacao* calendario, DataCompacta inicio, int dias) {
+    DataCompacta fim = inicio + dias;
+    if (calendario->bits != NULL && inicio >= calendario->primeiro_dia &&
+        fim <= calendario->primeiro_dia + calendario->num_dias) {
+        return;
+    }
+
+    // Cresce com folga (pelo menos o dobro) para amortizar as realocações
+    DataCompacta novo_primeiro = inicio;
+    DataCompacta novo_fim = fim;
+    if (calendario->bits != NULL) {
+        DataCompacta atual_fim = calendario->primeiro_dia + calendario->num_dias;
+        int folga = calendario->num_dias;
+        if (inicio < calendario->primeiro_dia) {
+            novo_primeiro = inicio < calendario->primeiro_dia - folga ? inicio : calendario->primeiro_dia - folga;
+        } else {
+            novo_primeiro = calendario->primeiro_dia;
+        }
+        if (fim > atual_fim) {
+            novo_fim = fim > atual_fim + folga ? fim : atual_fim + folga;
+        } else {
+            novo_fim = atual_fim;
+        }
+    } else if (novo_fim - novo_primeiro < 366) {
+        novo_fim = novo_primeiro + 366;
+    }
+
+    int novo_num = novo_fim - novo_primeiro;
+    size_t palavras = (size_t) calendario->palavras;
+    _Atomic uint64_t* novos = (_Atomic uint64_t*) calloc((size_t) novo_num * palavras, sizeof(uint64_t));
+    AgregadoDia* novos_totais = (AgregadoDia*) calloc((size_t) novo_num, sizeof(AgregadoDia));
+    if (novos == NULL || novos_totais == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    if (calendario->bits != NULL) {
+        int deslocamento = calendario->primeiro_dia - novo_primeiro;
+        memcpy((uint64_t*) &novos[(size_t) deslocamento * palavras], (uint64_t*) calendario->bits,
+               (size_t) calendario->num_dias * palavras * sizeof(uint64_t));
+        memcpy(&novos_totais[deslocamento], calendario->totais, (size_t) calendario->num_dias * sizeof(AgregadoDia));
+        free((void*) calendario->bits);
+        free(calendario->totais);
+    }
+    calendario->bits = novos;
+    calendario->totais = novos_totais;
+    calendario->primeiro_dia = novo_primeiro;
+    calendario->num_dias = novo_num;
+}
+
+// Função para obter a palavra do quarto na posição 'posicao' no dia 'dia' da janela
+static _Atomic uint64_t* calendario_palavra(const CalendarioOcupacao* calendario, int dia, int posicao) {
+    return &calendario->bits[(size_t) dia * calendario->palavras + posicao / 64];
+}
+
+// Função para marcar (ocupado = 1) ou desmarcar o quarto nos dias [inicio, inicio + dias)
+static void calendario_marcar(CalendarioOcupacao* calendario, int posicao, DataCompacta inicio, int dias, int ocupado) {
+    if (posicao < 0 || dias <= 0 || inicio == DATA_INVALIDA) {
+        return;
+    }
+    if (ocupado) {
+        calendario_garantir(calendario, inicio, dias);
+    } else if (calendario->bits == NULL) {
+        return;
+    }
+
+    uint64_t mascara = (uint64_t) 1 << (posicao % 64);
+    int dia = inicio - calendario->primeiro_dia;
+    for (int i = 0; i < dias; i++) {
+        _Atomic uint64_t* palavra = calendario_palavra(calendario, dia + i, posicao);
+        if (ocupado) {
+            atomic_fetch_or_explicit(palavra, mascara, memory_order_relaxed);
+        } else {
+            atomic_fetch_and_explicit(palavra, ~mascara, memory_order_relaxed);
+        }
+    }
+}
+
+// Função para saber se a janela do calendário já cobre [inicio, inicio + dias)
+static int calendario_cobre(const CalendarioOcupacao* calendario, DataCompacta inicio, int dias) {
+    return calendario->bits != NULL && inicio >= calendario->primeiro_dia &&
+           inicio + dias <= calendario->primeiro_dia + calendario->num_dias;
+}
+
+// Função para saber se o quarto está livre (nem reservado nem reivindicado)
+// em todos os dias [inicio, inicio + dias)
+static int calendario_quarto_livre(const CalendarioOcupacao* calendario, int posicao, DataCompacta inicio, int dias) {
+    uint64_t mascara = (uint64_t) 1 << (posicao % 64);
+    for (int i = 0; i < dias; i++) {
+        DataCompacta d = inicio + i;
+        if (calendario->bits != NULL && d >= calendario->primeiro_dia &&
+            d < calendario->primeiro_dia + calendario->num_dias &&
+            (atomic_load_explicit(calendario_palavra(calendario, d - calendario->primeiro_dia, posicao),
+                                  memory_order_acquire) & mascara)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Função para reivindicar o quarto em [inicio, inicio + dias) sem trava: liga
+// o bit do quarto dia a dia, em ordem, com compare-and-swap. Se algum dia já
+// estiver ocupado, desliga os bits ligados até ali e retorna 0. Quem chama
+// tem a trava de leitura e já garantiu (calendario_cobre) que a janela cobre
+// o período, para que o vetor de dias não seja realocado no meio.
+static int calendario_reivindicar(CalendarioOcupacao* calendario, ContadoresDisputa* disputa,
+                                  int posicao, DataCompacta inicio, int dias) {
+    uint64_t mascara = (uint64_t) 1 << (posicao % 64);
+    int dia = inicio - calendario->primeiro_dia;
+    for (int i = 0; i < dias; i++) {
+        _Atomic uint64_t* palavra = calendario_palavra(calendario, dia + i, posicao);
+        uint64_t atual = atomic_load_explicit(palavra, memory_order_relaxed);
+        for (;;) {
+            if (atual & mascara) {
+                // Ocupado ou disputado por outro pedido: desfaz e falha já
+                for (int j = 0; j < i; j++) {
+                    atomic_fetch_and_explicit(calendario_palavra(calendario, dia + j, posicao), ~mascara,
+                                              memory_order_release);
+                }
+                return 0;
+            }
+            if (atomic_compare_exchange_weak_explicit(palavra, &atual, atual | mascara,
+                                                      memory_order_acq_rel, memory_order_relaxed)) {
+                break;
+            }
+            // Outro quarto da mesma palavra mudou (ou falha espúria): tenta de novo
+            atomic_fetch_add_explicit(&disputa->repeticoes, 1, memory_order_relaxed);
+        }
+    }
+    return 1;
+}
+
+// Função para somar (sinal = 1) ou subtrair (sinal = -1) a reserva dos totais
+// de cada dia da estadia, em O(num_diarias)
+static void calendario_somar_reserva(CalendarioOcupacao* calendario, const Reserva* reserva, int sinal) {
+    if (reserva->num_diarias <= 0 || reserva->inicio == DATA_INVALIDA) {
+        return;
+    }
+    if (sinal > 0) {
+        calendario_garantir(calendario, reserva->inicio, reserva->num_diarias);
+    } else if (calendario->bits == NULL) {
+        return;
+    }
+
+    double diaria = (double) reserva->preco / reserva->num_diarias;
+    AgregadoDia* total = &calendario->totais[reserva->inicio - calendario->primeiro_dia];
+    for (int i = 0; i < reserva->num_diarias; i++) {
+        total[i].hospedes += sinal * reserva->num_pessoas;
+        total[i].quartos_ocupados += sinal;
+        total[i].receita += sinal * diaria;
+    }
+}
+
+static void calendario_limpar(CalendarioOcupacao* calendario) {
+    free((void*) calendario->bits);
+    free(calendario->totais);
+    calendario->bits = NULL;
+    calendario->totais = NULL;
+    calendario->primeiro_dia = 0;
+    calendario->num_dias = 0;
+}
+
+static int contar_bits(uint64_t palavra) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(palavra);
+#else
+    palavra = palavra - ((palavra >> 1) & 0x5555555555555555ull);
+    palavra = (palavra & 0x3333333333333333ull) + ((palavra >> 2) & 0x3333333333333333ull);
+    palavra = (palavra + (palavra >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int) ((palavra * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Função para obter os quartos livres em todos os dias [inicio, inicio + dias):
+// junta (OU) as palavras dos dias do período e percorre os bits desligados.
+// Retorna quantos são e escreve os números dos 'max' primeiros.
+int quartosLivres(MotorReservas* motor, DataCompacta inicio, int dias, int* numeros, int max) {
+    const CalendarioOcupacao* calendario = &motor->calendario;
+    const TabelaQuartos* quartos = &motor->quartos;
+    pthread_rwlock_rdlock(&motor->trava);
+    int palavras = calendario->palavras;
+    uint64_t* ocupados = (uint64_t*) calloc((size_t) palavras, sizeof(uint64_t));
+    if (ocupados == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    if (calendario->bits != NULL && dias > 0) {
+        DataCompacta de = inicio > calendario->primeiro_dia ? inicio : calendario->primeiro_dia;
+        DataCompacta ate = inicio + dias;
+        if (ate > calendario->primeiro_dia + calendario->num_dias) {
+            ate = calendario->primeiro_dia + calendario->num_dias;
+        }
+        for (DataCompacta d = de; d < ate; d++) {
+            const _Atomic uint64_t* dia = calendario_palavra(calendario, d - calendario->primeiro_dia, 0);
+            for (int w = 0; w < palavras; w++) {
+                ocupados[w] |= atomic_load_explicit(&dia[w], memory_order_relaxed);
+            }
+        }
+    }
+
+    int total = 0;
+    int escritos = 0;
+    for (int w = 0; w < palavras; w++) {
+        // Só os bits 0..num_quartos - 1 correspondem a quartos
+        uint64_t livres = ~ocupados[w];
+        int resto = quartos->num_quartos - w * 64;
+        if (resto < 64) {
+            livres &= resto > 0 ? ((uint64_t) 1 << resto) - 1 : 0;
+        }
+        total += contar_bits(livres);
+        for (uint64_t b = livres; b != 0 && escritos < max; b &= b - 1) {
+            int bit = contar_bits((b & (~b + 1)) - 1);  // Índice do bit ligado mais baixo
+            numeros[escritos++] = quartos->quartos[w * 64 + bit].numero;
+        }
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    free(ocupados);
+    return total;
+}
+
+// Função para consultar os totais de um dia sem percorrer a lista
+static AgregadoDia calendario_agregado(const CalendarioOcupacao* calendario, DataCompacta dia) {
+    AgregadoDia agregado = {0, 0, 0.0};
+    if (calendario->bits != NULL && dia >= calendario->primeiro_dia &&
+        dia < calendario->primeiro_dia + calendario->num_dias) {
+        agregado = calendario->totais[dia - calendario->primeiro_dia];
+    }
+    return agregado;
+}
+
+// Função para obter quantas pessoas ainda cabem no hotel em todos os dias
+// [inicio, inicio + dias), dado o limite do hotel, em O(dias)
+static int calendario_capacidade(const CalendarioOcupacao* calendario, int limite, DataCompacta inicio, int dias) {
+    int maior = 0;
+    for (int i = 0; i < dias; i++) {
+        int hospedes = calendario_agregado(calendario, inicio + i).hospedes;
+        if (hospedes > maior) {
+            maior = hospedes;
+        }
+    }
+    return limite - maior;
+}
+
+AgregadoDia obterAgregadoDia(MotorReservas* motor, DataCompacta dia) {
+    pthread_rwlock_rdlock(&motor->trava);
+    AgregadoDia agregado = calendario_agregado(&motor->calendario, dia);
+    pthread_rwlock_unlock(&motor->trava);
+    return agregado;
+}
+
+int capacidadeDisponivel(MotorReservas* motor, DataCompacta inicio, int dias) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int capacidade = calendario_capacidade(&motor->calendario, motor->quartos.capacidade_total, inicio, dias);
+    pthread_rwlock_unlock(&motor->trava);
+    return capacidade;
+}
+
+// Função para obter o dia da semana (0 = domingo); 01/01/1970 foi uma quinta-feira
+static int dia_semana(long long dia) {
+    int resto = (int) ((dia + 4) % 7);
+    return resto < 0 ? resto + 7 : resto;
+}
+
+// Função para deixar todos os tipos com a tarifa padrão, sem temporadas
+static void tarifas_iniciar(TabelaTarifas* tarifas) {
+    for (int t = 0; t < TIPOS_QUARTO_MAX; t++) {
+        tarifas->tipos[t].base = PRECO_RESERVA;
+        for (int d = 0; d < 7; d++) {
+            tarifas->tipos[t].fator_semana[d] = 1.0;
+        }
+    }
+}
+
+// Função para obter a tarifa de um dia da janela (posição a partir de primeiro_dia)
+static double tarifas_dia(const TabelaTarifas* tarifas, const TarifasTipo* tipo, int posicao) {
+    double tarifa = tipo->temporada[posicao] > 0.0 ? tipo->temporada[posicao] : tipo->base;
+    return tarifa * tipo->fator_semana[dia_semana((long long) tarifas->primeiro_dia + posicao)];
+}
+
+// Função para refazer as somas parciais dos blocos [de, ate) de um tipo e o
+// acumulado de todos os blocos a partir de 'de', em O(dias tocados + blocos)
+static void tarifas_recalcular(const TabelaTarifas* tarifas, TarifasTipo* tipo, int de, int ate) {
+    for (int b = de; b < ate; b++) {
+        double soma = 0.0;
+        for (int i = b * TARIFA_BLOCO; i < (b + 1) * TARIFA_BLOCO; i++) {
+            tipo->parcial[i] = soma;
+            soma += tarifas_dia(tarifas, tipo, i);
+        }
+    }
+    int num_blocos = tarifas->num_dias / TARIFA_BLOCO;
+    for (int b = de; b < num_blocos; b++) {
+        int ultimo = (b + 1) * TARIFA_BLOCO - 1;
+        tipo->acumulado[b + 1] = tipo->acumulado[b] + tipo->parcial[ultimo] + tarifas_dia(tarifas, tipo, ultimo);
+    }
+}
+
+// Função para ampliar a janela das temporadas até cobrir [inicio, inicio + dias)
+static void tarifas_garantir(TabelaTarifas* tarifas, DataCompacta inicio, int dias) {
+    DataCompacta fim = inicio + dias;
+    if (tarifas->num_dias > 0 && inicio >= tarifas->primeiro_dia &&
+        fim <= tarifas->primeiro_dia + tarifas->num_dias) {
+        return;
+    }
+
+    // Cresce com folga (pelo menos o dobro), como o calendário de ocupação
+    DataCompacta novo_primeiro = inicio;
+    DataCompacta novo_fim = fim;
+    if (tarifas->num_dias > 0) {
+        DataCompacta atual_fim = tarifas->primeiro_dia + tarifas->num_dias;
+        int folga = tarifas->num_dias;
+        if (inicio < tarifas->primeiro_dia) {
+            novo_primeiro = inicio < tarifas->primeiro_dia - folga ? inicio : tarifas->primeiro_dia - folga;
+        } else {
+            novo_primeiro = tarifas->primeiro_dia;
+        }
+        if (fim > atual_fim) {
+            novo_fim = fim > atual_fim + folga ? fim : atual_fim + folga;
+        } else {
+            novo_fim = atual_fim;
+        }
+    } else if (novo_fim - novo_primeiro < 366) {
+        novo_fim = novo_primeiro + 366;
+    }
+
+    int novo_num = (novo_fim - novo_primeiro + TARIFA_BLOCO - 1) / TARIFA_BLOCO * TARIFA_BLOCO;
+    int deslocamento = tarifas->primeiro_dia - novo_primeiro;
+    for (int t = 0; t < TIPOS_QUARTO_MAX; t++) {
+        TarifasTipo* tipo = &tarifas->tipos[t];
+        double* temporada = (double*) calloc((size_t) novo_num, sizeof(double));
+        double* parcial = (double*) malloc((size_t) novo_num * sizeof(double));
+        double* acumulado = (double*) calloc((size_t) (novo_num / TARIFA_BLOCO + 1), sizeof(double));
+        if (temporada == NULL || parcial == NULL || acumulado == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        if (tipo->temporada != NULL) {
+            memcpy(&temporada[deslocamento], tipo->temporada, (size_t) tarifas->num_dias * sizeof(double));
+        }
+        free(tipo->temporada);
+        free(tipo->parcial);
+        free(tipo->acumulado);
+        tipo->temporada = temporada;
+        tipo->parcial = parcial;
+        tipo->acumulado = acumulado;
+    }
+    tarifas->primeiro_dia = novo_primeiro;
+    tarifas->num_dias = novo_num;
+    for (int t = 0; t < TIPOS_QUARTO_MAX; t++) {
+        tarifas_recalcular(tarifas, &tarifas->tipos[t], 0, novo_num / TARIFA_BLOCO);
+    }
+}
+
+// Função para obter a soma das tarifas da janela antes da posição (0..num_dias)
+static double tarifas_prefixo(const TabelaTarifas* tarifas, const TarifasTipo* tipo, int posicao) {
+    if (posicao >= tarifas->num_dias) {
+        return tipo->acumulado[tarifas->num_dias / TARIFA_BLOCO];
+    }
+    return tipo->acumulado[posicao / TARIFA_BLOCO] + tipo->parcial[posicao];
+}
+
+// Função para somar a base com o fator do dia da semana nos dias [inicio, fim)
+static double tarifas_somar_base(const TarifasTipo* tipo, long long inicio, long long fim) {
+    if (fim <= inicio) {
+        return 0.0;
+    }
+    long long semanas = (fim - inicio) / 7;
+    int resto = (int) ((fim - inicio) % 7);
+    int primeiro = dia_semana(inicio);
+    double soma = 0.0;
+    for (int d = 0; d < 7; d++) {
+        long long vezes = semanas + ((d - primeiro + 7) % 7 < resto);
+        soma += (double) vezes * tipo->fator_semana[d];
+    }
+    return soma * tipo->base;
+}
+
+// Função para somar as tarifas de um tipo nas diárias [inicio, inicio + dias), em O(1)
+static double tarifas_somar(const TabelaTarifas* tarifas, int tipo, DataCompacta inicio, int dias) {
+    const TarifasTipo* t = &tarifas->tipos[tipo];
+    long long de = inicio;
+    long long ate = (long long) inicio + dias;
+    if (tarifas->num_dias == 0) {
+        return tarifas_somar_base(t, de, ate);
+    }
+
+    long long janela_inicio = tarifas->primeiro_dia;
+    long long janela_fim = janela_inicio + tarifas->num_dias;
+    double soma = 0.0;
+    if (de < janela_inicio) {
+        soma += tarifas_somar_base(t, de, ate < janela_inicio ? ate : janela_inicio);
+    }
+    if (ate > janela_fim) {
+        soma += tarifas_somar_base(t, de > janela_fim ? de : janela_fim, ate);
+    }
+    long long dentro_de = de > janela_inicio ? de : janela_inicio;
+    long long dentro_ate = ate < janela_fim ? ate : janela_fim;
+    if (dentro_de < dentro_ate) {
+        soma += tarifas_prefixo(tarifas, t, (int) (dentro_ate - janela_inicio)) -
+                tarifas_prefixo(tarifas, t, (int) (dentro_de - janela_inicio));
+    }
+    return soma;
+}
+
+// Função para calcular o preço de uma reserva (arredondado em centavos)
+// pelas tarifas do tipo do quarto no layout
+static double preco_reserva(const MotorReservas* motor, const Reserva* reserva) {
+    const TabelaTarifas* tarifas = &motor->tarifas;
+    int posicao = quarto_posicao(&motor->quartos, reserva->quarto_id);
+    int tipo = posicao >= 0 ? motor->quartos.quartos[posicao].tipo : 0;
+    double diarias;
+    if (reserva->inicio == DATA_INVALIDA || reserva->num_diarias < 1) {
+        diarias = tarifas->tipos[tipo].base * reserva->num_diarias;
+    } else {
+        diarias = tarifas_somar(tarifas, tipo, reserva->inicio, reserva->num_diarias);
+    }
+    double centavos = diarias * reserva->num_pessoas * 100.0;
+    return (double) (long long) (centavos + (centavos < 0.0 ? -0.5 : 0.5)) / 100.0;
+}
+
+static void tarifas_limpar(TabelaTarifas* tarifas) {
+    for (int t = 0; t < TIPOS_QUARTO_MAX; t++) {
+        free(tarifas->tipos[t].temporada);
+        free(tarifas->tipos[t].parcial);
+        free(tarifas->tipos[t].acumulado);
+        tarifas->tipos[t].temporada = NULL;
+        tarifas->tipos[t].parcial = NULL;
+        tarifas->tipos[t].acumulado = NULL;
+    }
+    tarifas->num_dias = 0;
+}
+
+// Alterações das tarifas, com a trava de escrita já tomada. A base e os
+// fatores valem para todos os dias, então refazem as somas do tipo inteiro;
+// uma temporada refaz só os seus blocos.
+static void tarifas_definir_base(TabelaTarifas* tarifas, int tipo, double tarifa) {
+    tarifas->tipos[tipo].base = tarifa;
+    if (tarifas->num_dias > 0) {
+        tarifas_recalcular(tarifas, &tarifas->tipos[tipo], 0, tarifas->num_dias / TARIFA_BLOCO);
+    }
+}
+
+static void tarifas_definir_fator(TabelaTarifas* tarifas, int tipo, int dia, double fator) {
+    tarifas->tipos[tipo].fator_semana[dia] = fator;
+    if (tarifas->num_dias > 0) {
+        tarifas_recalcular(tarifas, &tarifas->tipos[tipo], 0, tarifas->num_dias / TARIFA_BLOCO);
+    }
+}
+
+static void tarifas_definir_temporada(TabelaTarifas* tarifas, int tipo, DataCompacta inicio, int dias, double tarifa) {
+    tarifas_garantir(tarifas, inicio, dias);
+    TarifasTipo* t = &tarifas->tipos[tipo];
+    int de = inicio - tarifas->primeiro_dia;
+    for (int i = 0; i < dias; i++) {
+        t->temporada[de + i] = tarifa;
+    }
+    tarifas_recalcular(tarifas, t, de / TARIFA_BLOCO, (de + dias - 1) / TARIFA_BLOCO + 1);
+}
+
+int definirTarifaBase(MotorReservas* motor, int tipo, double tarifa) {
+    if (tipo < 0 || tipo >= TIPOS_QUARTO_MAX || !(tarifa > 0.0)) {
+        return 0;
+    }
+    pthread_rwlock_wrlock(&motor->trava);
+    tarifas_definir_base(&motor->tarifas, tipo, tarifa);
+    pthread_rwlock_unlock(&motor->trava);
+    return 1;
+}
+
+int definirFatorSemana(MotorReservas* motor, int tipo, int dia, double fator) {
+    if (tipo < 0 || tipo >= TIPOS_QUARTO_MAX || dia < 0 || dia > 6 || !(fator > 0.0)) {
+        return 0;
+    }
+    pthread_rwlock_wrlock(&motor->trava);
+    tarifas_definir_fator(&motor->tarifas, tipo, dia, fator);
+    pthread_rwlock_unlock(&motor->trava);
+    return 1;
+}
+
+int definirTarifaTemporada(MotorReservas* motor, int tipo, DataCompacta inicio, int dias, double tarifa) {
+    if (tipo < 0 || tipo >= TIPOS_QUARTO_MAX || inicio == DATA_INVALIDA || dias < 1 ||
+        dias > TEMPORADA_MAX_DIAS || !(tarifa >= 0.0)) {
+        return 0;
+    }
+    pthread_rwlock_wrlock(&motor->trava);
+    tarifas_definir_temporada(&motor->tarifas, tipo, inicio, dias, tarifa);
+    pthread_rwlock_unlock(&motor->trava);
+    return 1;
+}
+
+// Função para calcular o preço de uma estadia sem reservar; é o mesmo preço
+// que inserirReserva e reservarQuarto cobrariam agora. Retorna -1 se os dados
+// forem inválidos.
+double calcularPreco(MotorReservas* motor, int quarto, DataCompacta inicio, int dias, int pessoas) {
+    if (inicio == DATA_INVALIDA || dias < 1 || pessoas < 1) {
+        return -1.0;
+    }
+    Reserva reserva;
+    reserva.quarto_id = quarto;
+    reserva.inicio = inicio;
+    reserva.num_diarias = dias;
+    reserva.num_pessoas = pessoas;
+    pthread_rwlock_rdlock(&motor->trava);
+    double preco = quarto_posicao(&motor->quartos, quarto) >= 0 ? preco_reserva(motor, &reserva) : -1.0;
+    pthread_rwlock_unlock(&motor->trava);
+    return preco;
+}
+
+// Arquivo de tarifas: uma regra por linha, aplicadas em ordem; '#' inicia
+// um comentário. As tarifas são por pessoa por diária; o tipo de cada
+// quarto vem do layout (carregarQuartos).
+//   base <tipo> <tarifa>
+//   semana <tipo> <dom> <seg> <ter> <qua> <qui> <sex> <sáb>   (fatores)
+//   temporada <tipo> <DD/MM/AAAA> <DD/MM/AAAA> <tarifa>      (primeira e última diária)
+enum { REGRA_BASE, REGRA_SEMANA, REGRA_TEMPORADA };
+
+typedef struct {
+    int regra;
+    int tipo;
+    DataCompacta inicio; // temporada
+    int dias;
+    double valores[7];   // Tarifa ou fatores da semana
+} RegraTarifa;
+
+// Função para interpretar uma linha do arquivo de tarifas. Retorna 1 se
+// havia uma regra, 0 se a linha estava vazia e -1 se for inválida.
+static int tarifas_ler_regra(char* linha, RegraTarifa* regra, const char** motivo) {
+    char* comentario = strchr(linha, '#');
+    if (comentario != NULL) {
+        *comentario = '\0';
+    }
+    char comando[16];
+    int lidos = 0;
+    int campos = sscanf(linha, "%15s %d%n", comando, &regra->tipo, &lidos);
+    if (campos == EOF || campos == 0) {
+        return 0;
+    }
+    if (campos == 1) {
+        *motivo = "tipo inválido";
+        return -1;
+    }
+    const char* resto = linha + lidos;
+    char extra[2];
+    memset(regra->valores, 0, sizeof(regra->valores));
+    *motivo = "regra inválida";
+    if (strcmp(comando, "base") == 0) {
+        regra->regra = REGRA_BASE;
+        if (sscanf(resto, "%lf %1s", &regra->valores[0], extra) != 1 || !(regra->valores[0] > 0.0)) {
+            *motivo = "tarifa inválida";
+            return -1;
+        }
+    } else if (strcmp(comando, "semana") == 0) {
+        regra->regra = REGRA_SEMANA;
+        double* v = regra->valores;
+        if (sscanf(resto, "%lf %lf %lf %lf %lf %lf %lf %1s", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                   extra) != 7) {
+            *motivo = "são necessários 7 fatores (domingo a sábado)";
+            return -1;
+        }
+        for (int d = 0; d < 7; d++) {
+            if (!(v[d] > 0.0)) {
+                *motivo = "fator inválido";
+                return -1;
+            }
+        }
+    } else if (strcmp(comando, "temporada") == 0) {
+        regra->regra = REGRA_TEMPORADA;
+        char de[11], ate[11];
+        if (sscanf(resto, "%10s %10s %lf %1s", de, ate, &regra->valores[0], extra) != 3 ||
+            !(regra->valores[0] >= 0.0)) {
+            *motivo = "use temporada <tipo> <DD/MM/AAAA> <DD/MM/AAAA> <tarifa>";
+            return -1;
+        }
+        regra->inicio = parse_data_compacta(de);
+        DataCompacta fim = parse_data_compacta(ate);
+        if (regra->inicio == DATA_INVALIDA || fim == DATA_INVALIDA || fim < regra->inicio ||
+            fim - regra->inicio >= TEMPORADA_MAX_DIAS) {
+            *motivo = "período inválido";
+            return -1;
+        }
+        regra->dias = fim - regra->inicio + 1;
+    } else {
+        *motivo = "regra desconhecida";
+        return -1;
+    }
+    if (regra->tipo < 0 || regra->tipo >= TIPOS_QUARTO_MAX) {
+        *motivo = "tipo de quarto inválido";
+        return -1;
+    }
+    return 1;
+}
+
+// Função para carregar as tarifas de um arquivo, tudo ou nada: com alguma
+// linha inválida nada é aplicado. Retorna quantas regras foram aplicadas,
+// 0 se o arquivo não existir e -1 se ele for inválido.
+int carregarTarifas(MotorReservas* motor, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    RegraTarifa* regras = NULL;
+    int num_regras = 0;
+    int capacidade = 0;
+    int erros = 0;
+    long numero_linha = 0;
+    char linha[512];
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        RegraTarifa regra;
+        const char* motivo = NULL;
+        int lida = tarifas_ler_regra(linha, &regra, &motivo);
+        if (lida < 0) {
+            printf("%s, linha %ld: %s\n", caminho, numero_linha, motivo);
+            erros++;
+            continue;
+        }
+        if (lida == 0) {
+            continue;
+        }
+        if (num_regras == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 16;
+            RegraTarifa* novas = (RegraTarifa*) realloc(regras, (size_t) capacidade * sizeof(RegraTarifa));
+            if (novas == NULL) {
+                printf("Erro de alocação de memória!\n");
+                exit(1);
+            }
+            regras = novas;
+        }
+        regras[num_regras++] = regra;
+    }
+    fclose(arquivo);
+    if (erros > 0) {
+        free(regras);
+        return -1;
+    }
+
+    pthread_rwlock_wrlock(&motor->trava);
+    TabelaTarifas* tarifas = &motor->tarifas;
+    for (int i = 0; i < num_regras; i++) {
+        const RegraTarifa* regra = &regras[i];
+        switch (regra->regra) {
+            case REGRA_BASE:
+                tarifas_definir_base(tarifas, regra->tipo, regra->valores[0]);
+                break;
+            case REGRA_SEMANA:
+                for (int d = 0; d < 7; d++) {
+                    tarifas_definir_fator(tarifas, regra->tipo, d, regra->valores[d]);
+                }
+                break;
+            default:
+                tarifas_definir_temporada(tarifas, regra->tipo, regra->inicio, regra->dias, regra->valores[0]);
+        }
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    free(regras);
+    return num_regras;
+}
+
+// Função para gerar a chave de busca de um nome: letras minúsculas, acentos
+// do Latin-1 (UTF-8) trocados pela letra base e espaços repetidos reduzidos
+// a um. Retorna o tamanho da chave (no máximo NOME_CHAVE_MAX - 1).
+int normalizar_nome(const char* nome, char* chave) {
+    // Letra base para os caracteres U+00C0..U+00FF (segundo byte 0x80..0xBF após 0xC3)
+    static const char sem_acento[64] =
+        "aaaaaaaceeeeiiiidnooooo*ouuuuyts"
+        "aaaaaaaceeeeiiiidnooooo/ouuuuyty";
+    const unsigned char* c = (const unsigned char*) nome;
+    int tamanho = 0;
+    int espaco = 0;
+    while (*c != '\0' && tamanho < NOME_CHAVE_MAX - 1) {
+        unsigned char letra = *c++;
+        if (letra == 0xC3 && *c >= 0x80 && *c <= 0xBF) {
+            letra = (unsigned char) sem_acento[*c++ - 0x80];
+        } else if (letra >= 'A' && letra <= 'Z') {
+            letra = (unsigned char) (letra - 'A' + 'a');
+        }
+
+        if (letra == ' ' || letra == '\t') {
+            espaco = tamanho > 0;
+            continue;
+        }
+        if (espaco && tamanho < NOME_CHAVE_MAX - 2) {
+            chave[tamanho++] = ' ';
+        }
+        espaco = 0;
+        chave[tamanho++] = (char) letra;
+    }
+    chave[tamanho] = '\0';
+    return tamanho;
+}
+
+static int trie_novo_no(IndiceNomes* indice, unsigned char letra) {
+    if (indice->tamanho == indice->capacidade) {
+        int nova_capacidade = indice->capacidade ? indice->capacidade * 2 : 256;
+        NoTrie* nos = (NoTrie*) realloc(indice->nos, nova_capacidade * sizeof(NoTrie));
+        if (nos == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        indice->nos = nos;
+        indice->capacidade = nova_capacidade;
+    }
+    NoTrie* no = &indice->nos[indice->tamanho];
+    no->filho = TRIE_NENHUM;
+    no->irmao = TRIE_NENHUM;
+    no->ids = NULL;
+    no->num_ids = 0;
+    no->capacidade_ids = 0;
+    no->letra = letra;
+    return indice->tamanho++;
+}
+
+// Função para descer da raiz pela chave; retorna o nó final ou TRIE_NENHUM
+static int trie_descer(const IndiceNomes* indice, const char* chave) {
+    if (indice->tamanho == 0) {
+        return TRIE_NENHUM;
+    }
+    int atual = 0;
+    for (const unsigned char* c = (const unsigned char*) chave; *c != '\0'; c++) {
+        int filho = indice->nos[atual].filho;
+        while (filho != TRIE_NENHUM && indice->nos[filho].letra != *c) {
+            filho = indice->nos[filho].irmao;
+        }
+        if (filho == TRIE_NENHUM) {
+            return TRIE_NENHUM;
+        }
+        atual = filho;
+    }
+    return atual;
+}
+
+static void nomes_inserir(IndiceNomes* indice, const char* nome, int reserva_id) {
+    char chave[NOME_CHAVE_MAX];
+    normalizar_nome(nome, chave);
+    if (indice->tamanho == 0) {
+        trie_novo_no(indice, 0);  // Raiz
+    }
+
+    int atual = 0;
+    for (const unsigned char* c = (const unsigned char*) chave; *c != '\0'; c++) {
+        int filho = indice->nos[atual].filho;
+        while (filho != TRIE_NENHUM && indice->nos[filho].letra != *c) {
+            filho = indice->nos[filho].irmao;
+        }
+        if (filho == TRIE_NENHUM) {
+            filho = trie_novo_no(indice, *c);  // Pode realocar indice->nos
+            indice->nos[filho].irmao = indice->nos[atual].filho;
+            indice->nos[atual].filho = filho;
+        }
+        atual = filho;
+    }
+
+    NoTrie* no = &indice->nos[atual];
+    if (no->num_ids == no->capacidade_ids) {
+        int nova_capacidade = no->capacidade_ids ? no->capacidade_ids * 2 : 2;
+        int* ids = (int*) realloc(no->ids, nova_capacidade * sizeof(int));
+        if (ids == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        no->ids = ids;
+        no->capacidade_ids = nova_capacidade;
+    }
+    no->ids[no->num_ids++] = reserva_id;
+}
+
+static void nomes_remover(IndiceNomes* indice, const char* nome, int reserva_id) {
+    char chave[NOME_CHAVE_MAX];
+    normalizar_nome(nome, chave);
+    int atual = trie_descer(indice, chave);
+    if (atual == TRIE_NENHUM) {
+        return;
+    }
+    NoTrie* no = &indice->nos[atual];
+    for (int i = 0; i < no->num_ids; i++) {
+        if (no->ids[i] == reserva_id) {
+            no->ids[i] = no->ids[--no->num_ids];
+            return;
+        }
+    }
+}
+
+// Função para buscar as reservas pelo nome completo (prefixo = 0) ou pelo
+// início do nome (prefixo = 1). Retorna quantas encontrou; os ids ficam em
+// *ids, que deve ser liberado com free.
+static int nomes_buscar(const IndiceNomes* indice, const char* nome, int prefixo, int** ids) {
+    char chave[NOME_CHAVE_MAX];
+    normalizar_nome(nome, chave);
+    *ids = NULL;
+    int inicio = trie_descer(indice, chave);
+    if (inicio == TRIE_NENHUM) {
+        return 0;
+    }
+
+    int total = 0;
+    int capacidade = 0;
+    int* pilha = NULL;
+    int topo = 0;
+    int capacidade_pilha = 0;
+    int atual = inicio;
+    for (;;) {
+        const NoTrie* no = &indice->nos[atual];
+        if (no->num_ids > 0) {
+            if (total + no->num_ids > capacidade) {
+                capacidade = (total + no->num_ids) * 2;
+                int* novos = (int*) realloc(*ids, capacidade * sizeof(int));
+                if (novos == NULL) {
+                    printf("Erro de alocação de memória!\n");
+                    exit(1);
+                }
+                *ids = novos;
+            }
+            memcpy(&(*ids)[total], no->ids, no->num_ids * sizeof(int));
+            total += no->num_ids;
+        }
+        if (!prefixo) {
+            break;
+        }
+
+        // Percorre a subárvore em profundidade com pilha explícita
+        if (atual != inicio && no->irmao != TRIE_NENHUM) {
+            if (topo == capacidade_pilha) {
+                capacidade_pilha = capacidade_pilha ? capacidade_pilha * 2 : 64;
+                int* nova_pilha = (int*) realloc(pilha, capacidade_pilha * sizeof(int));
+                if (nova_pilha == NULL) {
+                    printf("Erro de alocação de memória!\n");
+                    exit(1);
+                }
+                pilha = nova_pilha;
+            }
+            pilha[topo++] = no->irmao;
+        }
+        if (no->filho != TRIE_NENHUM) {
+            atual = no->filho;
+        } else if (topo > 0) {
+            atual = pilha[--topo];
+        } else {
+            break;
+        }
+    }
+    free(pilha);
+    return total;
+}
+
+static void nomes_limpar(IndiceNomes* indice) {
+    for (int i = 0; i < indice->tamanho; i++) {
+        free(indice->nos[i].ids);
+    }
+    free(indice->nos);
+    indice->nos = NULL;
+    indice->tamanho = 0;
+    indice->capacidade = 0;
+}
+
+// Função para verificar a disponibilidade do quarto em O(log q + log k),
+// onde q é o número de quartos do hotel e k o de reservas do próprio quarto
+static int quarto_livre(MotorReservas* motor, int room, DataCompacta new_start, int new_days) {
+    int posicao = quarto_posicao(&motor->quartos, room);
+    if (posicao < 0) {
+        return 0; // Quarto inexistente
+    }
+    const IntervalosQuarto* quarto = &motor->intervalos[posicao];
+
+    // Como os intervalos não se sobrepõem, basta olhar o último que começa antes do fim
+    int pos = quarto_posicao_inicio(quarto, new_start + new_days);
+    if (pos > 0) {
+        const Intervalo* anterior = &quarto->itens[pos - 1];
+        if (ranges_overlap(anterior->inicio, anterior->fim - anterior->inicio, new_start, new_days)) {
+            return 0; // Não disponível
+        }
+    }
+    return 1; // Disponível
+}
+
+int isRoomAvailable(MotorReservas* motor, int room, DataCompacta new_start, int new_days) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int livre = quarto_livre(motor, room, new_start, new_days);
+    pthread_rwlock_unlock(&motor->trava);
+    return livre;
+}
+
+// O observador é chamado com a trava de escrita tomada, na thread que alterou
+// a lista; ele não deve chamar funções do motor que tomam a trava
+void definirObservadorReservas(MotorReservas* motor, ObservadorReservas observador, void* dados) {
+    pthread_rwlock_wrlock(&motor->trava);
+    motor->observador = observador;
+    motor->dados_observador = dados;
+    pthread_rwlock_unlock(&motor->trava);
+}
+
+// Função para inserir uma reserva já completa (id, preço e data compacta
+// calculados) em todas as estruturas; usada também ao reproduzir o diário.
+// Uma reserva de quarto fora do layout entra na lista, mas não ocupa quarto.
+static No* inserirReservaPronta(MotorReservas* motor, Reserva reserva) {
+    int posicao_quarto = quarto_posicao(&motor->quartos, reserva.quarto_id);
+    No* novo_no = pool_alocar_no(&motor->pool);
+    novo_no->reserva = reserva;
+    novo_no->linha = tabela_inserir(&motor->tabela, &reserva, posicao_quarto);
+    novo_no->prox = NULL;
+    novo_no->ant = NULL;
+
+    indice_inserir(&motor->indice, reserva.reserva_id, novo_no);
+    quarto_adicionar_intervalo(motor, posicao_quarto, reserva.inicio, reserva.num_diarias, reserva.reserva_id);
+    calendario_somar_reserva(&motor->calendario, &reserva, 1);
+    nomes_inserir(&motor->nomes, reserva.nome_cliente, reserva.reserva_id);
+
+    // Insere já na posição ordenada por data
+    int posicao = saltos_inserir(&motor->saltos, novo_no);
+    if (motor->observador != NULL) {
+        motor->observador(EVENTO_INSERCAO, novo_no, posicao, motor->dados_observador);
+    }
+    return novo_no;
+}
+
+// Função para inserir uma reserva com as mesmas conferências de reservarQuarto
+// (quarto, sobreposição e capacidade). Completa reserva_id, preco e inicio em
+// 'nova_reserva' e retorna o id, ou 0 se a reserva foi recusada.
+int inserirReserva(MotorReservas* motor, Reserva* nova_reserva) {
+    return reservarQuarto(motor, nova_reserva) == LOTE_OK ? nova_reserva->reserva_id : 0;
+}
+
+// Função para reservar um quarto se ele estiver livre em todo o período e
+// houver capacidade em todos os dias: conferência e inserção são uma só
+// operação, sem a janela entre isRoomAvailable e inserirReserva. Completa
+// reserva_id, preco e inicio em 'nova_reserva' e retorna LOTE_OK ou o
+// motivo da recusa (LOTE_QUARTO_INVALIDO, LOTE_DADOS_INVALIDOS,
+// LOTE_CONFLITO_EXISTENTE, LOTE_CAPACIDADE ou LOTE_ERRO_DIARIO).
+int reservarQuarto(MotorReservas* motor, Reserva* nova_reserva) {
+    DataCompacta inicio = parse_data_compacta(nova_reserva->data_inicio);
+    int dias = nova_reserva->num_diarias;
+    nova_reserva->inicio = inicio;
+    if (inicio == DATA_INVALIDA || dias < 1 || dias > DIARIAS_MAX || nova_reserva->num_pessoas < 1) {
+        return LOTE_DADOS_INVALIDOS;
+    }
+    ContadoresDisputa* disputa = &motor->disputa;
+    atomic_fetch_add_explicit(&disputa->tentativas, 1, memory_order_relaxed);
+
+    // Ampliar a janela do calendário realoca os dias, então exige a trava de
+    // escrita; só é feito para um quarto do layout que comporta o pedido. O
+    // layout pode mudar enquanto a trava está solta, então o quarto é
+    // procurado de novo a cada volta.
+    CalendarioOcupacao* calendario = &motor->calendario;
+    pthread_rwlock_rdlock(&motor->trava);
+    int quarto = quarto_posicao(&motor->quartos, nova_reserva->quarto_id);
+    while (quarto >= 0 && nova_reserva->num_pessoas <= motor->quartos.quartos[quarto].capacidade &&
+           !calendario_cobre(calendario, inicio, dias)) {
+        pthread_rwlock_unlock(&motor->trava);
+        pthread_rwlock_wrlock(&motor->trava);
+        calendario_garantir(calendario, inicio, dias);
+        pthread_rwlock_unlock(&motor->trava);
+        pthread_rwlock_rdlock(&motor->trava);
+        quarto = quarto_posicao(&motor->quartos, nova_reserva->quarto_id);
+    }
+    int resultado = LOTE_OK;
+    if (quarto < 0) {
+        resultado = LOTE_QUARTO_INVALIDO;
+    } else if (nova_reserva->num_pessoas > motor->quartos.quartos[quarto].capacidade ||
+               nova_reserva->num_pessoas > calendario_capacidade(calendario, motor->quartos.capacidade_total, inicio, dias)) {
+        resultado = LOTE_CAPACIDADE;
+    } else if (!calendario_reivindicar(calendario, disputa, quarto, inicio, dias)) {
+        resultado = LOTE_CONFLITO_EXISTENTE;
+        atomic_fetch_add_explicit(&disputa->conflitos, 1, memory_order_relaxed);
+    }
+    pthread_rwlock_unlock(&motor->trava);
+
+    if (resultado == LOTE_OK) {
+        // O quarto já é deste pedido; a capacidade é do hotel inteiro e pode
+        // ter mudado desde a leitura, então é conferida de novo
+        pthread_rwlock_wrlock(&motor->trava);
+        if (nova_reserva->num_pessoas >
+            calendario_capacidade(calendario, motor->quartos.capacidade_total, inicio, dias)) {
+            calendario_marcar(calendario, quarto, inicio, dias, 0);
+            resultado = LOTE_CAPACIDADE;
+            atomic_fetch_add_explicit(&disputa->desfeitas, 1, memory_order_relaxed);
+        } else {
+            // O diário vem antes das estruturas: se a escrita falhar, nada muda
+            nova_reserva->preco = preco_reserva(motor, nova_reserva);
+            nova_reserva->reserva_id = atomic_fetch_add(&motor->proximo_id, 1);
+            if (!diario_registrar(motor, DIARIO_INSERCAO, nova_reserva)) {
+                calendario_marcar(calendario, quarto, inicio, dias, 0);
+                resultado = LOTE_ERRO_DIARIO;
+            } else {
+                inserirReservaPronta(motor, *nova_reserva);
+                diario_compactar_se_cheio(motor);
+                atomic_fetch_add_explicit(&disputa->aceitas, 1, memory_order_relaxed);
+            }
+        }
+        pthread_rwlock_unlock(&motor->trava);
+    }
+    return resultado;
+}
+
+EstatisticasDisputa obterEstatisticasDisputa(MotorReservas* motor) {
+    EstatisticasDisputa estatisticas;
+    estatisticas.tentativas = atomic_load(&motor->disputa.tentativas);
+    estatisticas.aceitas = atomic_load(&motor->disputa.aceitas);
+    estatisticas.conflitos = atomic_load(&motor->disputa.conflitos);
+    estatisticas.repeticoes = atomic_load(&motor->disputa.repeticoes);
+    estatisticas.desfeitas = atomic_load(&motor->disputa.desfeitas);
+    return estatisticas;
+}
+
+// Comparação por quarto e data de início, para ordenar o lote
+static int comparar_quarto_data(const void* a, const void* b) {
+    const Reserva* ra = *(const Reserva* const*) a;
+    const Reserva* rb = *(const Reserva* const*) b;
+    if (ra->quarto_id != rb->quarto_id) {
+        return ra->quarto_id < rb->quarto_id ? -1 : 1;
+    }
+    if (ra->inicio != rb->inicio) {
+        return ra->inicio < rb->inicio ? -1 : 1;
+    }
+    return 0;
+}
+
+// Função para intercalar duas listas ordenadas por data em O(N + M)
+static No* intercalar_listas(No* a, No* b) {
+    No* cabeca = NULL;
+    No* cauda = NULL;
+    while (a != NULL || b != NULL) {
+        No* escolhido;
+        if (b == NULL || (a != NULL && compare_reserva_dates(&a->reserva, &b->reserva) <= 0)) {
+            escolhido = a;
+            a = a->prox;
+        } else {
+            escolhido = b;
+            b = b->prox;
+        }
+        if (cauda != NULL)
+            cauda->prox = escolhido;
+        else
+            cabeca = escolhido;
+        escolhido->ant = cauda;
+        cauda = escolhido;
+    }
+    if (cauda != NULL) {
+        cauda->prox = NULL;
+    }
+    return cabeca;
+}
+
+// Função para incluir um lote já validado: os nós são encadeados fora da
+// lista, ordenados uma única vez, intercalados com a lista existente e a
+// lista de saltos é reconstruída ao final. O lote vai para o diário antes,
+// como uma só entrada (DIARIO_LOTE), então é atômico em disco. Retorna 0,
+// sem alterar as reservas, se não foi possível gravá-lo no diário.
+static int lote_anexar(MotorReservas* motor, Reserva* lote, long n) {
+    for (long i = 0; i < n; i++) {
+        lote[i].reserva_id = atomic_fetch_add(&motor->proximo_id, 1);
+    }
+    if (!diario_registrar_lote(motor, lote, n)) {
+        return 0;
+    }
+
+    indice_reservar(&motor->indice, (size_t) n);
+    No* cabeca = NULL;
+    No* cauda = NULL;
+    for (long i = 0; i < n; i++) {
+        No* no = pool_alocar_no(&motor->pool);
+        int posicao_quarto = quarto_posicao(&motor->quartos, lote[i].quarto_id);
+        no->reserva = lote[i];
+        no->linha = tabela_inserir(&motor->tabela, &lote[i], posicao_quarto);
+        no->prox = NULL;
+        no->ant = cauda;
+        if (cauda != NULL)
+            cauda->prox = no;
+        else
+            cabeca = no;
+        cauda = no;
+
+        const Reserva* reserva = &no->reserva;
+        indice_inserir(&motor->indice, reserva->reserva_id, no);
+        quarto_adicionar_intervalo(motor, posicao_quarto, reserva->inicio, reserva->num_diarias, reserva->reserva_id);
+        calendario_somar_reserva(&motor->calendario, reserva, 1);
+        nomes_inserir(&motor->nomes, reserva->nome_cliente, reserva->reserva_id);
+    }
+
+    cabeca = ordenar_lista(&motor->tabela, cabeca, n, &cauda);
+    No** novos = (No**) malloc((size_t) n * sizeof(No*));
+    if (novos == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    long k = 0;
+    for (No* no = cabeca; no != NULL; no = no->prox) {
+        novos[k++] = no;
+    }
+    cabeca = intercalar_listas(motor->saltos.cabeca[0], cabeca);
+    saltos_reconstruir(&motor->saltos, cabeca);
+
+    // A intercalação mantém a ordem do lote: os novos aparecem na lista na
+    // mesma ordem de 'novos', e cada posição já conta os anteriores
+    if (motor->observador != NULL) {
+        int posicao = 0;
+        k = 0;
+        for (No* no = cabeca; no != NULL && k < n; no = no->prox, posicao++) {
+            if (no == novos[k]) {
+                motor->observador(EVENTO_INSERCAO, no, posicao, motor->dados_observador);
+                k++;
+            }
+        }
+    }
+
+    free(novos);
+    diario_compactar_se_cheio(motor);
+    return 1;
+}
+
+// Função para inserir várias reservas de uma vez, tudo ou nada. O lote é
+// ordenado por quarto e data e cada quarto é conferido em uma única passagem
+// que intercala as reservas do lote com os intervalos já ocupados; a
+// capacidade diária é conferida com uma soma de prefixos sobre o período do
+// lote. O custo é O(n log n) para ordenar mais O(n + k + dias) para validar.
+// Se o lote for incluído, preenche reserva_id, inicio e (se zerado) preco de
+// cada reserva; se for recusado, 'reservas' não é alterado. Se 'situacao'
+// não for NULL, recebe o resultado LOTE_* de cada uma.
+// Retorna 1 se o lote foi incluído e 0 se foi recusado (nada é alterado).
+static int inserir_lote(MotorReservas* motor, Reserva* originais, long quantidade, int* situacao) {
+    // A validação completa inicio e preco numa cópia
+    Reserva* reservas = (Reserva*) malloc((size_t) (quantidade > 0 ? quantidade : 1) * sizeof(Reserva));
+    Reserva** ordem = (Reserva**) malloc((size_t) (quantidade > 0 ? quantidade : 1) * sizeof(Reserva*));
+    if (reservas == NULL || ordem == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    memcpy(reservas, originais, (size_t) quantidade * sizeof(Reserva));
+
+    long recusadas = 0;
+    DataCompacta menor = 0;
+    DataCompacta maior = 0;
+    long validas = 0;
+    for (long i = 0; i < quantidade; i++) {
+        Reserva* reserva = &reservas[i];
+        int resultado = LOTE_OK;
+        reserva->inicio = parse_data_compacta(reserva->data_inicio);
+        int posicao = quarto_posicao(&motor->quartos, reserva->quarto_id);
+        if (posicao < 0) {
+            resultado = LOTE_QUARTO_INVALIDO;
+        } else if (reserva->inicio == DATA_INVALIDA || reserva->num_diarias < 1 ||
+                   reserva->num_diarias > DIARIAS_MAX || reserva->num_pessoas < 1) {
+            resultado = LOTE_DADOS_INVALIDOS;
+        } else if (reserva->num_pessoas > motor->quartos.quartos[posicao].capacidade) {
+            resultado = LOTE_CAPACIDADE;
+        } else {
+            if (reserva->preco <= 0.0) {
+                reserva->preco = preco_reserva(motor, reserva);
+            }
+            if (validas == 0 || reserva->inicio < menor) {
+                menor = reserva->inicio;
+            }
+            if (validas == 0 || reserva->inicio + reserva->num_diarias > maior) {
+                maior = reserva->inicio + reserva->num_diarias;
+            }
+            ordem[validas++] = reserva;
+        }
+        if (situacao != NULL) {
+            situacao[i] = resultado;
+        }
+        if (resultado != LOTE_OK) {
+            recusadas++;
+        }
+    }
+    qsort(ordem, (size_t) validas, sizeof(Reserva*), comparar_quarto_data);
+
+    // Sobreposições: o lote de cada quarto e os intervalos do quarto já
+    // estão ordenados por início, então basta avançar os dois juntos
+    long i = 0;
+    while (i < validas) {
+        int room = ordem[i]->quarto_id;
+        int posicao = quarto_posicao(&motor->quartos, room);
+        const IntervalosQuarto* quarto = &motor->intervalos[posicao];
+        int j = 0;
+        DataCompacta fim_anterior = DATA_INVALIDA;  // Fim da reserva anterior do lote neste quarto
+        for (; i < validas && ordem[i]->quarto_id == room; i++) {
+            Reserva* reserva = ordem[i];
+            DataCompacta fim = reserva->inicio + reserva->num_diarias;
+            while (j < quarto->tamanho && quarto->itens[j].fim <= reserva->inicio) {
+                j++;
+            }
+            int resultado = LOTE_OK;
+            if (reserva->inicio < fim_anterior) {
+                resultado = LOTE_CONFLITO_LOTE;
+            } else if ((j < quarto->tamanho && quarto->itens[j].inicio < fim) ||
+                       !calendario_quarto_livre(&motor->calendario, posicao, reserva->inicio, reserva->num_diarias)) {
+                // O calendário mostra também os quartos reivindicados por
+                // reservarQuarto e ainda não inseridos
+                resultado = LOTE_CONFLITO_EXISTENTE;
+            }
+            if (fim > fim_anterior) {
+                fim_anterior = fim;
+            }
+            if (resultado != LOTE_OK) {
+                if (situacao != NULL) {
+                    situacao[reserva - reservas] = resultado;
+                }
+                recusadas++;
+            }
+        }
+    }
+
+    // Capacidade: soma as pessoas do lote por dia (diferenças e prefixos)
+    // e compara com os totais já registrados
+    if (validas > 0) {
+        long dias = (long) maior - menor;
+        int* variacao = (int*) calloc((size_t) dias + 1, sizeof(int));
+        if (variacao == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        for (long k = 0; k < validas; k++) {
+            variacao[ordem[k]->inicio - menor] += ordem[k]->num_pessoas;
+            variacao[ordem[k]->inicio + ordem[k]->num_diarias - menor] -= ordem[k]->num_pessoas;
+        }
+        int excedido = 0;
+        int pessoas = 0;
+        for (long d = 0; d < dias; d++) {
+            pessoas += variacao[d];
+            variacao[d] = pessoas + calendario_agregado(&motor->calendario, menor + (DataCompacta) d).hospedes >
+                         motor->quartos.capacidade_total;
+            excedido |= variacao[d];
+        }
+        if (excedido) {
+            // Marca as reservas que passam por algum dia lotado
+            for (long k = 0; k < validas; k++) {
+                Reserva* reserva = ordem[k];
+                for (int d = 0; d < reserva->num_diarias; d++) {
+                    if (variacao[reserva->inicio + d - menor]) {
+                        if (situacao != NULL && situacao[reserva - reservas] == LOTE_OK) {
+                            situacao[reserva - reservas] = LOTE_CAPACIDADE;
+                        }
+                        recusadas++;
+                        break;
+                    }
+                }
+            }
+        }
+        free(variacao);
+    }
+    free(ordem);
+
+    if (recusadas > 0) {
+        free(reservas);
+        return 0;
+    }
+    if (quantidade > 0) {
+        if (!lote_anexar(motor, reservas, quantidade)) {
+            for (long k = 0; situacao != NULL && k < quantidade; k++) {
+                situacao[k] = LOTE_ERRO_DIARIO;
+            }
+            free(reservas);
+            return 0;
+        }
+        memcpy(originais, reservas, (size_t) quantidade * sizeof(Reserva));
+    }
+    free(reservas);
+    return 1;
+}
+
+int inserirReservasLote(MotorReservas* motor, Reserva* reservas, long quantidade, int* situacao) {
+    pthread_rwlock_wrlock(&motor->trava);
+    int incluido = inserir_lote(motor, reservas, quantidade, situacao);
+    pthread_rwlock_unlock(&motor->trava);
+    return incluido;
+}
+
+// Função para remover uma reserva pelo ID; retorna 1 se ela existia, 0 se
+// não existia e -1 se não foi possível gravar a remoção no diário (a
+// reserva continua)
+static int remover_reserva(MotorReservas* motor, int id) {
+    No* temp = indice_buscar(&motor->indice, id);
+
+    if (temp == NULL) {
+        return 0;
+    } else if (!diario_registrar(motor, DIARIO_REMOCAO, &temp->reserva)) {
+        return -1;
+    } else {
+        int posicao = saltos_remover(&motor->saltos, temp);
+        if (motor->observador != NULL) {
+            motor->observador(EVENTO_REMOCAO, temp, posicao, motor->dados_observador);
+        }
+
+        quarto_remover_intervalo(motor, motor->tabela.posicao_quarto[temp->linha], temp->reserva.inicio, id);
+        calendario_somar_reserva(&motor->calendario, &temp->reserva, -1);
+        nomes_remover(&motor->nomes, temp->reserva.nome_cliente, id);
+        indice_remover(&motor->indice, id);
+        tabela_remover(&motor->tabela, temp->linha);
+        pool_liberar_no(&motor->pool, temp);
+        diario_compactar_se_cheio(motor);
+        return 1;
+    }
+}
+
+int removerReserva(MotorReservas* motor, int id) {
+    pthread_rwlock_wrlock(&motor->trava);
+    int removida = remover_reserva(motor, id);
+    pthread_rwlock_unlock(&motor->trava);
+    return removida;
+}
+
+// Função para buscar uma reserva pelo ID. Copia a reserva para 'reserva',
+// pois o nó pode ser removido por outra thread logo depois; retorna 0 se
+// ela não existe.
+int buscarReserva(MotorReservas* motor, int id, Reserva* reserva) {
+    pthread_rwlock_rdlock(&motor->trava);
+    No* temp = indice_buscar(&motor->indice, id);
+    if (temp != NULL) {
+        *reserva = temp->reserva;
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    return temp != NULL;
+}
+
+// Função para liberar todas as reservas. Os nós vêm do pool, então a lista
+// inteira é devolvida em blocos, sem percorrê-la nó a nó.
+static void liberar_estruturas(MotorReservas* motor) {
+    pool_liberar_tudo(&motor->pool);
+    indice_limpar(&motor->indice);
+    tabela_limpar(&motor->tabela);
+    for (int i = 0; i < motor->quartos.num_quartos; i++) {
+        free(motor->intervalos[i].itens);
+        motor->intervalos[i].itens = NULL;
+        motor->intervalos[i].tamanho = 0;
+        motor->intervalos[i].capacidade = 0;
+    }
+    calendario_limpar(&motor->calendario);
+    nomes_limpar(&motor->nomes);
+    for (int nivel = 0; nivel < NIVEIS_SALTO; nivel++) {
+        motor->saltos.cabeca[nivel] = NULL;
+    }
+    motor->saltos.altura = 1;
+    motor->saltos.tamanho = 0;
+    motor->saltos.cauda = NULL;
+}
+
+void liberarReservas(MotorReservas* motor) {
+    pthread_rwlock_wrlock(&motor->trava);
+    liberar_estruturas(motor);
+    pthread_rwlock_unlock(&motor->trava);
+}
+
+// Função para trocar o layout do hotel por 'quartos' (já ordenados por
+// número, sem repetições; o motor passa a ser dono do vetor). Quem chama tem
+// a trava de escrita e o motor não tem reservas.
+static void quartos_instalar(MotorReservas* motor, Quarto* quartos, int quantidade, int capacidade_total) {
+    liberar_estruturas(motor);
+    free(motor->quartos.quartos);
+    free(motor->intervalos);
+    motor->intervalos = (IntervalosQuarto*) calloc((size_t) quantidade, sizeof(IntervalosQuarto));
+    if (motor->intervalos == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    motor->quartos.quartos = quartos;
+    motor->quartos.num_quartos = quantidade;
+    motor->quartos.capacidade_total = capacidade_total;
+    motor->calendario.palavras = (quantidade + 63) / 64;
+}
+
+// Função para montar o layout sem quartos.txt: quartos 1 a QUARTOS_PADRAO do
+// tipo 0 e até CAPACIDADE_PADRAO hóspedes por dia no hotel
+static void quartos_padrao(MotorReservas* motor) {
+    Quarto* quartos = (Quarto*) malloc(QUARTOS_PADRAO * sizeof(Quarto));
+    if (quartos == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    for (int i = 0; i < QUARTOS_PADRAO; i++) {
+        quartos[i].numero = i + 1;
+        quartos[i].andar = 0;
+        quartos[i].tipo = 0;
+        quartos[i].capacidade = CAPACIDADE_PADRAO;
+    }
+    quartos_instalar(motor, quartos, QUARTOS_PADRAO, CAPACIDADE_PADRAO);
+}
+
+// Comparação por número, para ordenar o layout
+static int comparar_quartos(const void* a, const void* b) {
+    const Quarto* qa = (const Quarto*) a;
+    const Quarto* qb = (const Quarto*) b;
+    if (qa->numero != qb->numero) {
+        return qa->numero < qb->numero ? -1 : 1;
+    }
+    return 0;
+}
+
+// Função para validar e ordenar um layout; retorna a cópia ordenada ou NULL
+// se houver algum quarto inválido ou repetido (o número em *repetido, se
+// for o caso)
+static Quarto* quartos_preparar(const Quarto* quartos, int quantidade, int* repetido) {
+    *repetido = 0;
+    if (quantidade < 1 || quantidade > QUARTOS_MAX) {
+        return NULL;
+    }
+    for (int i = 0; i < quantidade; i++) {
+        if (quartos[i].numero < 1 || quartos[i].tipo < 0 || quartos[i].tipo >= TIPOS_QUARTO_MAX ||
+            quartos[i].capacidade < 1) {
+            return NULL;
+        }
+    }
+    Quarto* ordenados = (Quarto*) malloc((size_t) quantidade * sizeof(Quarto));
+    if (ordenados == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    memcpy(ordenados, quartos, (size_t) quantidade * sizeof(Quarto));
+    qsort(ordenados, (size_t) quantidade, sizeof(Quarto), comparar_quartos);
+    for (int i = 1; i < quantidade; i++) {
+        if (ordenados[i].numero == ordenados[i - 1].numero) {
+            *repetido = ordenados[i].numero;
+            free(ordenados);
+            return NULL;
+        }
+    }
+    return ordenados;
+}
+
+// Função para instalar um layout já preparado (o vetor passa a ser do motor
+// ou é liberado); retorna 0 se o motor já tiver reservas
+static int quartos_trocar(MotorReservas* motor, Quarto* ordenados, int quantidade, int capacidade_total) {
+    if (capacidade_total == 0) {
+        long long soma = 0;
+        for (int i = 0; i < quantidade; i++) {
+            soma += ordenados[i].capacidade;
+        }
+        capacidade_total = soma > INT_MAX ? INT_MAX : (int) soma;
+    }
+
+    pthread_rwlock_wrlock(&motor->trava);
+    if (motor->saltos.tamanho > 0) {
+        pthread_rwlock_unlock(&motor->trava);
+        free(ordenados);
+        return 0;
+    }
+    quartos_instalar(motor, ordenados, quantidade, capacidade_total);
+    pthread_rwlock_unlock(&motor->trava);
+    return 1;
+}
+
+// Função para definir o layout do hotel; retorna 0 se algum quarto for
+// inválido ou repetido ou se o motor já tiver reservas
+int definirQuartos(MotorReservas* motor, const Quarto* quartos, int quantidade, int capacidade_total) {
+    int repetido;
+    Quarto* ordenados = quartos_preparar(quartos, quantidade, &repetido);
+    if (ordenados == NULL || capacidade_total < 0) {
+        free(ordenados);
+        return 0;
+    }
+    return quartos_trocar(motor, ordenados, quantidade, capacidade_total);
+}
+
+// Arquivo de quartos: um quarto (ou uma faixa de números) por linha e,
+// opcionalmente, o limite de hóspedes por dia no hotel; '#' inicia um
+// comentário. Sem a linha 'capacidade', o limite é a soma dos quartos.
+//   <número>[-<último>] <andar> <tipo> <capacidade>
+//   capacidade <hóspedes por dia>
+// Carrega tudo ou nada. Retorna quantos quartos o hotel passou a ter, 0 se o
+// arquivo não existir (fica o layout atual) e -1 se ele for inválido.
+int carregarQuartos(MotorReservas* motor, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    Quarto* quartos = NULL;
+    int num_quartos = 0;
+    int capacidade = 0;
+    int capacidade_total = 0;
+    int erros = 0;
+    long numero_linha = 0;
+    char linha[256];
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        char* comentario = strchr(linha, '#');
+        if (comentario != NULL) {
+            *comentario = '\0';
+        }
+        char extra[2];
+        int primeiro, ultimo, lidos;
+        Quarto quarto;
+        if (sscanf(linha, " %1s", extra) != 1) {
+            continue;
+        }
+        if (sscanf(linha, " capacidade %d %1s", &capacidade_total, extra) == 1) {
+            if (capacidade_total < 1) {
+                printf("%s, linha %ld: capacidade inválida\n", caminho, numero_linha);
+                erros++;
+            }
+            continue;
+        }
+        if (sscanf(linha, "%d%n", &primeiro, &lidos) != 1) {
+            printf("%s, linha %ld: use <número>[-<último>] <andar> <tipo> <capacidade>\n", caminho, numero_linha);
+            erros++;
+            continue;
+        }
+        const char* resto = linha + lidos;
+        ultimo = primeiro;
+        if (*resto == '-') {
+            if (sscanf(resto + 1, "%d%n", &ultimo, &lidos) != 1) {
+                ultimo = -1;
+            }
+            resto += 1 + lidos;
+        }
+        if (sscanf(resto, "%d %d %d %1s", &quarto.andar, &quarto.tipo, &quarto.capacidade, extra) != 3) {
+            printf("%s, linha %ld: use <número>[-<último>] <andar> <tipo> <capacidade>\n", caminho, numero_linha);
+            erros++;
+            continue;
+        }
+        if (primeiro < 1 || ultimo < primeiro) {
+            printf("%s, linha %ld: número de quarto inválido\n", caminho, numero_linha);
+            erros++;
+            continue;
+        }
+        if (quarto.tipo < 0 || quarto.tipo >= TIPOS_QUARTO_MAX) {
+            printf("%s, linha %ld: tipo de quarto inválido\n", caminho, numero_linha);
+            erros++;
+            continue;
+        }
+        if (quarto.capacidade < 1) {
+            printf("%s, linha %ld: capacidade do quarto inválida\n", caminho, numero_linha);
+            erros++;
+            continue;
+        }
+        if ((long long) ultimo - primeiro + 1 > QUARTOS_MAX - num_quartos) {
+            printf("%s, linha %ld: o hotel pode ter no máximo %d quartos\n", caminho, numero_linha, QUARTOS_MAX);
+            erros++;
+            break;
+        }
+        for (int numero = primeiro; numero <= ultimo; numero++) {
+            if (num_quartos == capacidade) {
+                capacidade = capacidade ? capacidade * 2 : 64;
+                Quarto* novos = (Quarto*) realloc(quartos, (size_t) capacidade * sizeof(Quarto));
+                if (novos == NULL) {
+                    printf("Erro de alocação de memória!\n");
+                    exit(1);
+                }
+                quartos = novos;
+            }
+            quarto.numero = numero;
+            quartos[num_quartos++] = quarto;
+        }
+    }
+    fclose(arquivo);
+    if (erros == 0 && num_quartos == 0) {
+        printf("%s: nenhum quarto definido\n", caminho);
+        erros++;
+    }
+    if (erros > 0) {
+        free(quartos);
+        return -1;
+    }
+
+    int repetido;
+    Quarto* ordenados = quartos_preparar(quartos, num_quartos, &repetido);
+    free(quartos);
+    if (ordenados == NULL) {
+        printf("%s: quarto %d aparece mais de uma vez\n", caminho, repetido);
+        return -1;
+    }
+    if (!quartos_trocar(motor, ordenados, num_quartos, capacidade_total)) {
+        printf("%s: o layout só pode ser trocado antes de carregar as reservas\n", caminho);
+        return -1;
+    }
+    return num_quartos;
+}
+
+int contarQuartos(MotorReservas* motor) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int total = motor->quartos.num_quartos;
+    pthread_rwlock_unlock(&motor->trava);
+    return total;
+}
+
+int capacidadeHotel(MotorReservas* motor) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int capacidade = motor->quartos.capacidade_total;
+    pthread_rwlock_unlock(&motor->trava);
+    return capacidade;
+}
+
+// Função para obter os dados de um quarto pelo número; retorna 0 se o hotel
+// não tem esse quarto
+int buscarQuarto(MotorReservas* motor, int numero, Quarto* quarto) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int posicao = quarto_posicao(&motor->quartos, numero);
+    if (posicao >= 0 && quarto != NULL) {
+        *quarto = motor->quartos.quartos[posicao];
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    return posicao >= 0;
+}
+
+// Função para obter o quarto na posição 'posicao' do layout (0 a
+// contarQuartos - 1, em ordem de número); retorna 0 fora da faixa
+int quartoNaPosicao(MotorReservas* motor, int posicao, Quarto* quarto) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int existe = posicao >= 0 && posicao < motor->quartos.num_quartos;
+    if (existe) {
+        *quarto = motor->quartos.quartos[posicao];
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    return existe;
+}
+
+// Função para criar um motor vazio, com o layout padrão
+MotorReservas* criarMotorReservas() {
+    MotorReservas* motor = (MotorReservas*) calloc(1, sizeof(MotorReservas));
+    if (motor == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    motor->saltos.altura = 1;
+    motor->saltos.semente = 2463534242u;
+    atomic_init(&motor->proximo_id, 1);
+    tarifas_iniciar(&motor->tarifas);
+    quartos_padrao(motor);
+    pthread_rwlock_init(&motor->trava, NULL);
+    pthread_mutex_init(&motor->diario.trava, NULL);
+    return motor;
+}
+
+// Função para liberar o motor e tudo o que ele contém; o diário, se aberto,
+// é sincronizado e fechado
+void liberarMotorReservas(MotorReservas* motor) {
+    if (motor == NULL) {
+        return;
+    }
+    diario_fechar(motor);
+    liberar_estruturas(motor);
+    free(motor->quartos.quartos);
+    free(motor->intervalos);
+    tarifas_limpar(&motor->tarifas);
+    pthread_rwlock_destroy(&motor->trava);
+    pthread_mutex_destroy(&motor->diario.trava);
+    free(motor);
+}
+
+// Função para buscar reservas pelo nome do cliente (nome completo ou, com
+// 'prefixo', início do nome). Retorna a quantidade de ids em *ids, que deve
+// ser liberado pelo chamador.
+int buscarReservasPorNome(MotorReservas* motor, const char* nome, int prefixo, int** ids) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int total = nomes_buscar(&motor->nomes, nome, prefixo, ids);
+    pthread_rwlock_unlock(&motor->trava);
+    return total;
+}
+
+int contarReservas(MotorReservas* motor) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int total = motor->saltos.tamanho;
+    pthread_rwlock_unlock(&motor->trava);
+    return total;
+}
+
+// Funções para percorrer a lista com outras threads alterando o motor: os
+// nós obtidos com primeiroNo, proximoNo etc. só são válidos enquanto a trava
+// de leitura estiver tomada. Sem outras threads não é preciso travar.
+void travarLeituraReservas(MotorReservas* motor) {
+    pthread_rwlock_rdlock(&motor->trava);
+}
+
+void destravarLeituraReservas(MotorReservas* motor) {
+    pthread_rwlock_unlock(&motor->trava);
+}
+
+No* primeiroNo(MotorReservas* motor) {
+    return motor->saltos.cabeca[0];
+}
+
+No* proximoNo(const No* no) {
+    return no->prox;
+}
+
+No* noAnterior(const No* no) {
+    return no->ant;
+}
+
+const Reserva* reservaDoNo(const No* no) {
+    return &no->reserva;
+}
+
+No* noNaPosicao(MotorReservas* motor, int indice) {
+    return saltos_no_na_posicao(&motor->saltos, indice);
+}
+
+int posicaoDoNo(MotorReservas* motor, const No* no) {
+    return saltos_posicao(&motor->saltos, no);
+}
+
+long linhaDoNo(const No* no) {
+    return no->linha;
+}
+
+// Função para obter as colunas da tabela de reservas. Os ponteiros valem até
+// a próxima alteração do motor.
+ColunasReservas obterColunasReservas(MotorReservas* motor) {
+    const TabelaColunas* tabela = &motor->tabela;
+    ColunasReservas colunas;
+    colunas.linhas = tabela->linhas;
+    colunas.reserva_id = tabela->reserva_id;
+    colunas.quarto_id = tabela->quarto_id;
+    colunas.posicao_quarto = tabela->posicao_quarto;
+    colunas.inicio = tabela->inicio;
+    colunas.num_diarias = tabela->num_diarias;
+    colunas.num_pessoas = tabela->num_pessoas;
+    colunas.preco = tabela->preco;
+    return colunas;
+}
+
+const char* nomeDaLinha(MotorReservas* motor, long linha) {
+    const TabelaColunas* tabela = &motor->tabela;
+    if (linha < 0 || linha >= tabela->linhas || tabela->reserva_id[linha] == 0) {
+        return NULL;
+    }
+    return tabela->nomes + tabela->nome[linha];
+}
+
+// Soma de verificação (FNV-1a sobre palavras de 32 bits) de um registro
+static uint32_t checksum_bytes(uint32_t soma, const void* registro, size_t tamanho) {
+    const unsigned char* bytes = (const unsigned char*) registro;
+    for (size_t i = 0; i + sizeof(uint32_t) <= tamanho; i += sizeof(uint32_t)) {
+        uint32_t palavra;
+        memcpy(&palavra, bytes + i, sizeof(palavra));
+        soma = (soma ^ palavra) * 16777619u;
+    }
+    return soma;
+}
+
+static uint32_t checksum_registro(uint32_t soma, const RegistroReserva* registro) {
+    return checksum_bytes(soma, registro, sizeof(*registro));
+}
+
+// Função para converter um registro da versão 1 (preço em float)
+static void registro_de_float(const RegistroReservaFloat* antigo, RegistroReserva* registro) {
+    memset(registro, 0, sizeof(*registro));
+    registro->reserva_id = antigo->reserva_id;
+    registro->quarto_id = antigo->quarto_id;
+    registro->inicio = antigo->inicio;
+    registro->num_diarias = antigo->num_diarias;
+    registro->num_pessoas = antigo->num_pessoas;
+    // O float guardava o valor arredondado em centavos; volta aos centavos
+    registro->preco = (double) (long long) ((double) antigo->preco * 100.0 + 0.5) / 100.0;
+    memcpy(registro->nome_cliente, antigo->nome_cliente, sizeof(registro->nome_cliente));
+}
+
+// Funções para converter entre Reserva e o registro de tamanho fixo em disco
+static void reserva_para_registro(const Reserva* reserva, RegistroReserva* registro) {
+    memset(registro, 0, sizeof(*registro));
+    registro->reserva_id = reserva->reserva_id;
+    registro->quarto_id = reserva->quarto_id;
+    registro->inicio = reserva->inicio;
+    registro->num_diarias = reserva->num_diarias;
+    registro->num_pessoas = reserva->num_pessoas;
+    registro->preco = reserva->preco;
+    snprintf(registro->nome_cliente, sizeof(registro->nome_cliente), "%s", reserva->nome_cliente);
+}
+
+static void registro_para_reserva(const RegistroReserva* registro, Reserva* reserva) {
+    reserva->reserva_id = registro->reserva_id;
+    reserva->quarto_id = registro->quarto_id;
+    memcpy(reserva->nome_cliente, registro->nome_cliente, sizeof(reserva->nome_cliente));
+    reserva->nome_cliente[sizeof(reserva->nome_cliente) - 1] = '\0';
+    formatar_data_compacta(registro->inicio, reserva->data_inicio);
+    reserva->num_diarias = registro->num_diarias;
+    reserva->num_pessoas = registro->num_pessoas;
+    reserva->preco = registro->preco;
+    reserva->inicio = registro->inicio;
+}
+
+// Função para mapear um arquivo inteiro na memória (somente leitura).
+// Retorna 1 se mapeou, 0 se o arquivo não existe e -1 se está vazio ou ilegível.
+static int mapear_arquivo(const char* caminho, const unsigned char** dados, size_t* tamanho) {
+#ifdef _WIN32
+    HANDLE arquivo = CreateFileA(caminho, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (arquivo == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND ? 0 : -1;
+    }
+    LARGE_INTEGER tamanho_arquivo;
+    if (!GetFileSizeEx(arquivo, &tamanho_arquivo) || tamanho_arquivo.QuadPart == 0) {
+        CloseHandle(arquivo);
+        return -1;
+    }
+    HANDLE mapa = CreateFileMappingA(arquivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    *dados = NULL;
+    if (mapa != NULL) {
+        *dados = (const unsigned char*) MapViewOfFile(mapa, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapa);  // A visão mantém o mapeamento vivo
+    }
+    CloseHandle(arquivo);
+    if (*dados == NULL) {
+        return -1;
+    }
+    *tamanho = (size_t) tamanho_arquivo.QuadPart;
+    return 1;
+#else
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return -1;
+    }
+    void* mapa = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        return -1;
+    }
+    madvise(mapa, (size_t) info.st_size, MADV_SEQUENTIAL);
+    *dados = (const unsigned char*) mapa;
+    *tamanho = (size_t) info.st_size;
+    return 1;
+#endif
+}
+
+static void desmapear_arquivo(const unsigned char* dados, size_t tamanho) {
+#ifdef _WIN32
+    (void)tamanho;
+    UnmapViewOfFile(dados);
+#else
+    munmap((void*) dados, tamanho);
+#endif
+}
+
+// Função para carregar as reservas de um arquivo binário mapeado em memória.
+// Retorna 1 se carregou, 0 se o arquivo não existe e -1 se está corrompido.
+int carregarReservas(MotorReservas* motor, const char* caminho) {
+    const unsigned char* dados;
+    size_t tamanho;
+    int mapeado = mapear_arquivo(caminho, &dados, &tamanho);
+    if (mapeado <= 0) {
+        return mapeado;
+    }
+
+    CabecalhoArquivo cabecalho;
+    if (tamanho < sizeof(cabecalho)) {
+        desmapear_arquivo(dados, tamanho);
+        return -1;
+    }
+    memcpy(&cabecalho, dados, sizeof(cabecalho));
+    size_t tamanho_registro = cabecalho.versao == ARQUIVO_VERSAO_FLOAT ? sizeof(RegistroReservaFloat)
+                                                                       : sizeof(RegistroReserva);
+    if (cabecalho.magico != ARQUIVO_MAGICO ||
+        (cabecalho.versao != ARQUIVO_VERSAO && cabecalho.versao != ARQUIVO_VERSAO_FLOAT) ||
+        cabecalho.tamanho_registro != tamanho_registro ||
+        cabecalho.num_registros != (tamanho - sizeof(cabecalho)) / tamanho_registro ||
+        (tamanho - sizeof(cabecalho)) % tamanho_registro != 0) {
+        desmapear_arquivo(dados, tamanho);
+        return -1;
+    }
+
+    const unsigned char* registros = dados + sizeof(cabecalho);
+    uint32_t soma = 2166136261u;
+    for (uint64_t i = 0; i < cabecalho.num_registros; i++) {
+        soma = checksum_bytes(soma, registros + i * tamanho_registro, tamanho_registro);
+    }
+    if (soma != cabecalho.checksum) {
+        desmapear_arquivo(dados, tamanho);
+        return -1;
+    }
+
+    // Os registros já estão em ordem: cada nó é anexado ao fim do nível 0
+    // e os índices são montados de uma vez ao final
+    pthread_rwlock_wrlock(&motor->trava);
+    liberar_estruturas(motor);
+    indice_reservar(&motor->indice, (size_t) cabecalho.num_registros);
+    No* cabeca = NULL;
+    No* cauda = NULL;
+    int maior_id = 0;
+    for (uint64_t i = 0; i < cabecalho.num_registros; i++) {
+        RegistroReserva registro;
+        if (cabecalho.versao == ARQUIVO_VERSAO_FLOAT) {
+            RegistroReservaFloat antigo;
+            memcpy(&antigo, registros + i * tamanho_registro, sizeof(antigo));
+            registro_de_float(&antigo, &registro);
+        } else {
+            memcpy(&registro, registros + i * tamanho_registro, sizeof(registro));
+        }
+
+        No* no = pool_alocar_no(&motor->pool);
+        Reserva* reserva = &no->reserva;
+        registro_para_reserva(&registro, reserva);
+        int posicao_quarto = quarto_posicao(&motor->quartos, reserva->quarto_id);
+        no->linha = tabela_inserir(&motor->tabela, reserva, posicao_quarto);
+
+        no->prox = NULL;
+        no->ant = cauda;
+        if (cauda != NULL)
+            cauda->prox = no;
+        else
+            cabeca = no;
+        cauda = no;
+
+        indice_inserir(&motor->indice, reserva->reserva_id, no);
+        quarto_adicionar_intervalo(motor, posicao_quarto, reserva->inicio, reserva->num_diarias, reserva->reserva_id);
+        calendario_somar_reserva(&motor->calendario, reserva, 1);
+        nomes_inserir(&motor->nomes, reserva->nome_cliente, reserva->reserva_id);
+        if (reserva->reserva_id > maior_id) {
+            maior_id = reserva->reserva_id;
+        }
+    }
+    desmapear_arquivo(dados, tamanho);
+
+    cabeca = ordenar_lista(&motor->tabela, cabeca, (long) cabecalho.num_registros, &cauda);  // Só confere, se o arquivo já estava ordenado
+    saltos_reconstruir(&motor->saltos, cabeca);
+    atomic_store(&motor->proximo_id, (int) cabecalho.proximo_id > maior_id ? (int) cabecalho.proximo_id : maior_id + 1);
+    pthread_rwlock_unlock(&motor->trava);
+    return 1;
+}
+
+// Função para garantir em disco o conteúdo de um arquivo aberto
+static int sincronizar_arquivo(FILE* arquivo) {
+    if (fflush(arquivo) != 0) {
+        return 0;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(arquivo)) == 0;
+#else
+    return fsync(fileno(arquivo)) == 0;
+#endif
+}
+
+// Função para gravar todas as reservas de forma atômica: escreve em um
+// arquivo temporário, sincroniza e só então o renomeia sobre o definitivo
+static int gravar_snapshot(MotorReservas* motor, const char* caminho) {
+    char temporario[512];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+
+    FILE* arquivo = fopen(temporario, "wb");
+    if (arquivo == NULL) {
+        printf("Erro ao gravar %s!\n", temporario);
+        return 0;
+    }
+    setvbuf(arquivo, NULL, _IOFBF, 1 << 16);
+
+    CabecalhoArquivo cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo);  // Reescrito ao final
+
+    uint32_t soma = 2166136261u;
+    uint64_t num_registros = 0;
+    for (No* temp = motor->saltos.cabeca[0]; temp != NULL; temp = temp->prox) {
+        RegistroReserva registro;
+        reserva_para_registro(&temp->reserva, &registro);
+
+        soma = checksum_registro(soma, &registro);
+        fwrite(&registro, sizeof(registro), 1, arquivo);
+        num_registros++;
+    }
+
+    cabecalho.magico = ARQUIVO_MAGICO;
+    cabecalho.versao = ARQUIVO_VERSAO;
+    cabecalho.tamanho_registro = sizeof(RegistroReserva);
+    cabecalho.proximo_id = (uint32_t) atomic_load(&motor->proximo_id);
+    cabecalho.num_registros = num_registros;
+    cabecalho.checksum = soma;
+    fseek(arquivo, 0, SEEK_SET);
+    fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo);
+
+    int ok = !ferror(arquivo) && sincronizar_arquivo(arquivo);
+    ok = (fclose(arquivo) == 0) && ok;
+    if (!ok) {
+        printf("Erro ao gravar %s!\n", temporario);
+        remove(temporario);
+        return 0;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(temporario, caminho, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+#else
+    if (rename(temporario, caminho) != 0) {
+#endif
+        printf("Erro ao substituir %s!\n", caminho);
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+int salvarReservas(MotorReservas* motor, const char* caminho) {
+    pthread_rwlock_rdlock(&motor->trava);
+    int ok = gravar_snapshot(motor, caminho);
+    pthread_rwlock_unlock(&motor->trava);
+    return ok;
+}
+
+// Função para obter um relógio monotônico em milissegundos
+static long long relogio_ms() {
+#ifdef _WIN32
+    return (long long) GetTickCount64();
+#else
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (long long) agora.tv_sec * 1000 + agora.tv_nsec / 1000000;
+#endif
+}
+
+// Função para truncar um arquivo (fechado) em 'tamanho' bytes
+static int truncar_arquivo(const char* caminho, long tamanho) {
+#ifdef _WIN32
+    HANDLE h = CreateFileA(caminho, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER pos;
+    pos.QuadPart = tamanho;
+    if (h == INVALID_HANDLE_VALUE || !SetFilePointerEx(h, pos, NULL, FILE_BEGIN) || !SetEndOfFile(h)) {
+        if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+        return 0;
+    }
+    CloseHandle(h);
+    return 1;
+#else
+    return truncate(caminho, tamanho) == 0;
+#endif
+}
+
+// Função para reaplicar as 'n' inserções de um lote, logo após a sua entrada
+// DIARIO_LOTE. Confere todas antes de aplicar qualquer uma; retorna quantas
+// foram aplicadas ou -1 se o lote estiver incompleto ou corrompido.
+static long diario_reproduzir_lote(MotorReservas* motor, FILE* arquivo, long n) {
+    long inicio = ftell(arquivo);
+    if (n < 1 || inicio < 0) {
+        return -1;
+    }
+    EntradaDiario entrada;
+    for (long i = 0; i < n; i++) {
+        if (fread(&entrada, sizeof(entrada), 1, arquivo) != 1 || entrada.tipo != DIARIO_INSERCAO ||
+            checksum_registro(2166136261u ^ entrada.tipo, &entrada.registro) != entrada.checksum) {
+            return -1;
+        }
+    }
+    fseek(arquivo, inicio, SEEK_SET);
+    long aplicadas = 0;
+    for (long i = 0; i < n && fread(&entrada, sizeof(entrada), 1, arquivo) == 1; i++) {
+        int id = entrada.registro.reserva_id;
+        if (indice_buscar(&motor->indice, id) == NULL) {
+            Reserva reserva;
+            registro_para_reserva(&entrada.registro, &reserva);
+            inserirReservaPronta(motor, reserva);
+            aplicadas++;
+        }
+        if (id >= atomic_load(&motor->proximo_id)) {
+            atomic_store(&motor->proximo_id, id + 1);
+        }
+    }
+    return aplicadas;
+}
+
+// Função para reaplicar o diário sobre as reservas carregadas do snapshot.
+// Como os ids nunca são reutilizados, reaplicar uma operação que o snapshot
+// já contém não tem efeito. Uma entrada final incompleta ou corrompida (queda
+// durante a escrita) encerra a reprodução e é descartada do arquivo.
+// Retorna o número de operações aplicadas, ou -1 em caso de erro de leitura.
+long diario_reproduzir(MotorReservas* motor, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    setvbuf(arquivo, NULL, _IOFBF, 1 << 16);
+
+    // O tipo da primeira entrada diz a versão do diário
+    uint32_t primeiro_tipo = 0;
+    int versao_float = fread(&primeiro_tipo, sizeof(primeiro_tipo), 1, arquivo) == 1 &&
+                       (primeiro_tipo == DIARIO_INSERCAO_FLOAT || primeiro_tipo == DIARIO_REMOCAO_FLOAT);
+    rewind(arquivo);
+
+    pthread_rwlock_wrlock(&motor->trava);
+    long aplicadas = 0;
+    long validos = 0;  // Bytes até a última entrada íntegra
+    EntradaDiario entrada;
+    for (;;) {
+        size_t tamanho_entrada = sizeof(entrada);
+        if (versao_float) {
+            EntradaDiarioFloat antiga;
+            tamanho_entrada = sizeof(antiga);
+            if (fread(&antiga, sizeof(antiga), 1, arquivo) != 1 ||
+                checksum_bytes(2166136261u ^ antiga.tipo, &antiga.registro, sizeof(antiga.registro)) != antiga.checksum) {
+                break;
+            }
+            entrada.tipo = antiga.tipo == DIARIO_INSERCAO_FLOAT ? DIARIO_INSERCAO :
+                           antiga.tipo == DIARIO_REMOCAO_FLOAT ? DIARIO_REMOCAO : 0;
+            registro_de_float(&antiga.registro, &entrada.registro);
+        } else if (fread(&entrada, sizeof(entrada), 1, arquivo) != 1 ||
+                   checksum_registro(2166136261u ^ entrada.tipo, &entrada.registro) != entrada.checksum) {
+            break;
+        }
+
+        if (entrada.tipo == DIARIO_LOTE && !versao_float) {
+            long n = entrada.registro.reserva_id;
+            long aplicadas_lote = diario_reproduzir_lote(motor, arquivo, n);
+            if (aplicadas_lote < 0) {
+                break;
+            }
+            aplicadas += aplicadas_lote;
+            validos += (long) ((n + 1) * (long) sizeof(entrada));
+            continue;
+        }
+
+        int id = entrada.registro.reserva_id;
+        if (entrada.tipo == DIARIO_INSERCAO) {
+            if (indice_buscar(&motor->indice, id) == NULL) {
+                Reserva reserva;
+                registro_para_reserva(&entrada.registro, &reserva);
+                inserirReservaPronta(motor, reserva);
+                aplicadas++;
+            }
+        } else if (entrada.tipo == DIARIO_REMOCAO) {
+            if (indice_buscar(&motor->indice, id) != NULL) {
+                remover_reserva(motor, id);
+                aplicadas++;
+            }
+        } else {
+            break;
+        }
+        if (id >= atomic_load(&motor->proximo_id)) {
+            atomic_store(&motor->proximo_id, id + 1);
+        }
+        validos += (long) tamanho_entrada;
+    }
+    pthread_rwlock_unlock(&motor->trava);
+    if (versao_float && validos > 0) {
+        pthread_mutex_lock(&motor->diario.trava);
+        motor->diario.converter = 1;
+        pthread_mutex_unlock(&motor->diario.trava);
+    }
+    int erro = ferror(arquivo);
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    fclose(arquivo);
+    if (erro) {
+        return -1;
+    }
+
+    if (tamanho > validos && !truncar_arquivo(caminho, validos)) {
+        return -1;
+    }
+    return aplicadas;
+}
+
+// Função para abrir o diário para novas operações (após a reprodução)
+int diario_abrir(MotorReservas* motor, const char* caminho, const char* caminho_snapshot, int janela_ms) {
+    pthread_mutex_lock(&motor->diario.trava);
+    motor->diario.arquivo = fopen(caminho, "ab");
+    if (motor->diario.arquivo == NULL) {
+        pthread_mutex_unlock(&motor->diario.trava);
+        printf("Erro ao abrir %s!\n", caminho);
+        return 0;
+    }
+    fseek(motor->diario.arquivo, 0, SEEK_END);
+    motor->diario.tamanho = (uint64_t) ftell(motor->diario.arquivo);
+    motor->diario.falhou = 0;
+    snprintf(motor->diario.caminho, sizeof(motor->diario.caminho), "%s", caminho);
+    snprintf(motor->diario.caminho_snapshot, sizeof(motor->diario.caminho_snapshot), "%s", caminho_snapshot);
+    motor->diario.janela_ms = janela_ms;
+    motor->diario.pendentes = 0;
+    int converter = motor->diario.converter;
+    motor->diario.converter = 0;
+    pthread_mutex_unlock(&motor->diario.trava);
+
+    // Um diário da versão 1 não pode receber entradas novas: o snapshot
+    // passa a conter tudo e o diário recomeça vazio
+    if (converter) {
+        pthread_rwlock_wrlock(&motor->trava);
+        int ok = diario_regravar(motor);
+        pthread_rwlock_unlock(&motor->trava);
+        if (!ok) {
+            diario_fechar(motor);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Função para sincronizar com o disco as entradas pendentes (trava do diário tomada)
+static int diario_descarregar(Diario* diario) {
+    if (diario->arquivo == NULL || diario->pendentes == 0) {
+        return 1;
+    }
+    if (!sincronizar_arquivo(diario->arquivo)) {
+        printf("Erro ao sincronizar o diário!\n");
+        return 0;
+    }
+    diario->pendentes = 0;
+    return 1;
+}
+
+// Função para desfazer uma escrita que falhou (trava do diário tomada): o
+// que sobrou no buffer é descartado e o arquivo volta a 'tamanho' bytes,
+// pois a reprodução para na primeira entrada corrompida e perderia todas as
+// seguintes. Se não for possível, o diário passa a recusar novas operações.
+static void diario_desfazer_escrita(Diario* diario) {
+    printf("Erro ao gravar o diário!\n");
+    fclose(diario->arquivo);
+    diario->arquivo = NULL;
+    if (truncar_arquivo(diario->caminho, (long) diario->tamanho)) {
+        diario->arquivo = fopen(diario->caminho, "ab");
+    }
+    if (diario->arquivo == NULL) {
+        diario->falhou = 1;
+        printf("Não foi possível restaurar %s; novas operações serão recusadas!\n", diario->caminho);
+    }
+}
+
+// Função para contar uma escrita no grupo do próximo fsync (trava do diário tomada)
+static void diario_agrupar(Diario* diario) {
+    long long agora = relogio_ms();
+    if (diario->pendentes++ == 0) {
+        diario->primeiro_pendente_ms = agora;
+    }
+    if (agora - diario->primeiro_pendente_ms >= diario->janela_ms) {
+        diario_descarregar(diario);
+    }
+}
+
+// Função para anexar uma operação ao diário (trava de escrita do motor
+// tomada), antes de aplicá-la às reservas. A entrada vai para o sistema
+// operacional na hora; o fsync é feito uma vez por janela para todo o grupo.
+// Retorna 0 se a operação não foi gravada e não deve ser aplicada.
+static int diario_registrar(MotorReservas* motor, uint32_t tipo, const Reserva* reserva) {
+    Diario* diario = &motor->diario;
+    pthread_mutex_lock(&diario->trava);
+    if (diario->falhou) {
+        pthread_mutex_unlock(&diario->trava);
+        return 0;
+    }
+    if (diario->arquivo == NULL) {
+        pthread_mutex_unlock(&diario->trava);
+        return 1;  // Diário fechado (carga inicial ou reprodução)
+    }
+
+    EntradaDiario entrada;
+    entrada.tipo = tipo;
+    reserva_para_registro(reserva, &entrada.registro);
+    entrada.checksum = checksum_registro(2166136261u ^ tipo, &entrada.registro);
+    if (fwrite(&entrada, sizeof(entrada), 1, diario->arquivo) != 1 || fflush(diario->arquivo) != 0) {
+        diario_desfazer_escrita(diario);
+        pthread_mutex_unlock(&diario->trava);
+        return 0;
+    }
+    diario->tamanho += sizeof(entrada);
+    diario_agrupar(diario);
+    pthread_mutex_unlock(&diario->trava);
+    return 1;
+}
+
+// Função para anexar um lote ao diário: uma entrada DIARIO_LOTE com a
+// quantidade seguida de uma DIARIO_INSERCAO por reserva (trava de escrita do
+// motor tomada). Retorna 0 se o lote não foi gravado.
+static int diario_registrar_lote(MotorReservas* motor, const Reserva* lote, long n) {
+    Diario* diario = &motor->diario;
+    pthread_mutex_lock(&diario->trava);
+    if (diario->falhou) {
+        pthread_mutex_unlock(&diario->trava);
+        return 0;
+    }
+    if (diario->arquivo == NULL) {
+        pthread_mutex_unlock(&diario->trava);
+        return 1;
+    }
+
+    EntradaDiario entrada;
+    entrada.tipo = DIARIO_LOTE;
+    memset(&entrada.registro, 0, sizeof(entrada.registro));
+    entrada.registro.reserva_id = (int32_t) n;
+    entrada.checksum = checksum_registro(2166136261u ^ entrada.tipo, &entrada.registro);
+    int ok = fwrite(&entrada, sizeof(entrada), 1, diario->arquivo) == 1;
+    for (long i = 0; ok && i < n; i++) {
+        entrada.tipo = DIARIO_INSERCAO;
+        reserva_para_registro(&lote[i], &entrada.registro);
+        entrada.checksum = checksum_registro(2166136261u ^ entrada.tipo, &entrada.registro);
+        ok = fwrite(&entrada, sizeof(entrada), 1, diario->arquivo) == 1;
+    }
+    if (!ok || fflush(diario->arquivo) != 0) {
+        diario_desfazer_escrita(diario);
+        pthread_mutex_unlock(&diario->trava);
+        return 0;
+    }
+    diario->tamanho += (uint64_t) (n + 1) * sizeof(entrada);
+    diario_agrupar(diario);
+    pthread_mutex_unlock(&diario->trava);
+    return 1;
+}
+
+// Função para compactar o diário que passou de DIARIO_LIMITE_COMPACTACAO
+// (trava de escrita do motor tomada). É chamada depois que a operação
+// registrada foi aplicada, pois o snapshot precisa contê-la.
+static void diario_compactar_se_cheio(MotorReservas* motor) {
+    pthread_mutex_lock(&motor->diario.trava);
+    int compactar = motor->diario.arquivo != NULL && motor->diario.tamanho >= DIARIO_LIMITE_COMPACTACAO;
+    pthread_mutex_unlock(&motor->diario.trava);
+    if (compactar) {
+        diario_regravar(motor);
+    }
+}
+
+// Função para sincronizar com o disco as entradas pendentes; chamada também
+// por um temporizador para que nenhuma operação espere mais que a janela.
+// Usa só a trava do diário, então não bloqueia as consultas.
+int diario_sincronizar(MotorReservas* motor) {
+    pthread_mutex_lock(&motor->diario.trava);
+    int ok = diario_descarregar(&motor->diario);
+    pthread_mutex_unlock(&motor->diario.trava);
+    return ok;
+}
+
+// Função para gravar um snapshot completo e esvaziar o diário. Quem chama
+// tem a trava de escrita do motor (ou acesso exclusivo a ele).
+static int diario_regravar(MotorReservas* motor) {
+    Diario* diario = &motor->diario;
+    pthread_mutex_lock(&diario->trava);
+    int ok = diario->arquivo != NULL && diario_descarregar(diario) &&
+             gravar_snapshot(motor, diario->caminho_snapshot);
+    // O snapshot já contém todas as operações; se houver queda antes do
+    // truncamento, reaplicar o diário antigo é inofensivo
+    if (ok && fflush(diario->arquivo) != 0) {
+        ok = 0;
+    }
+#ifdef _WIN32
+    if (ok && _chsize(_fileno(diario->arquivo), 0) != 0) {
+#else
+    if (ok && ftruncate(fileno(diario->arquivo), 0) != 0) {
+#endif
+        printf("Erro ao compactar o diário!\n");
+        ok = 0;
+    }
+    if (ok) {
+        fseek(diario->arquivo, 0, SEEK_SET);
+        diario->tamanho = 0;
+    }
+    pthread_mutex_unlock(&diario->trava);
+    return ok;
+}
+
+int diario_compactar(MotorReservas* motor) {
+    pthread_rwlock_wrlock(&motor->trava);
+    int ok = diario_regravar(motor);
+    pthread_rwlock_unlock(&motor->trava);
+    return ok;
+}
+
+void diario_fechar(MotorReservas* motor) {
+    pthread_mutex_lock(&motor->diario.trava);
+    if (motor->diario.arquivo != NULL) {
+        diario_descarregar(&motor->diario);
+        fclose(motor->diario.arquivo);
+        motor->diario.arquivo = NULL;
+    }
+    pthread_mutex_unlock(&motor->diario.trava);
+}
+
+// Função para ler um inteiro decimal que ocupa o campo inteiro
+static int csv_ler_inteiro(const char* campo, int* valor) {
+    char* fim;
+    errno = 0;
+    long lido = strtol(campo, &fim, 10);
+    if (fim == campo || *fim != '\0' || errno != 0 || lido < INT32_MIN || lido > INT32_MAX) {
+        return 0;
+    }
+    *valor = (int) lido;
+    return 1;
+}
+
+// Função para ler um preço com até duas casas decimais, aceitando ponto ou
+// vírgula; independe da localidade, ao contrário de strtod
+static int csv_ler_preco(const char* campo, double* preco) {
+    long long inteiro = 0;
+    long long centavos = 0;
+    const char* c = campo;
+    if (*c < '0' || *c > '9') {
+        return 0;
+    }
+    while (*c >= '0' && *c <= '9') {
+        inteiro = inteiro * 10 + (*c++ - '0');
+        if (inteiro > 1000000000LL) {
+            return 0;
+        }
+    }
+    if (*c == '.' || *c == ',') {
+        c++;
+        for (int casas = 0; casas < 2; casas++) {
+            centavos *= 10;
+            if (*c >= '0' && *c <= '9') {
+                centavos += *c++ - '0';
+            }
+        }
+    }
+    if (*c != '\0') {
+        return 0;
+    }
+    *preco = (double) (inteiro * 100 + centavos) / 100.0;
+    return 1;
+}
+
+// Função para validar uma linha e convertê-la em reserva; em caso de erro
+// escreve o motivo em 'erro' e retorna 0
+static int csv_linha_para_reserva(const LinhaCSV* linha, Reserva* reserva, char* erro, size_t tamanho_erro) {
+    if (linha->num_campos != CSV_NUM_CAMPOS && linha->num_campos != CSV_NUM_CAMPOS - 1) {
+        snprintf(erro, tamanho_erro, "esperados %d campos, encontrados %d", CSV_NUM_CAMPOS, linha->num_campos);
+        return 0;
+    }
+    if (linha->truncada) {
+        snprintf(erro, tamanho_erro, "campo com mais de %d caracteres", CSV_TAMANHO_CAMPO - 1);
+        return 0;
+    }
+
+    memset(reserva, 0, sizeof(*reserva));
+    if (!csv_ler_inteiro(linha->campos[1], &reserva->quarto_id) ||
+        reserva->quarto_id < 1) {
+        snprintf(erro, tamanho_erro, "quarto inválido \"%s\"", linha->campos[1]);
+        return 0;
+    }
+    if (linha->tamanhos[2] == 0) {
+        snprintf(erro, tamanho_erro, "nome do cliente vazio");
+        return 0;
+    }
+    memcpy(reserva->nome_cliente, linha->campos[2], (size_t) linha->tamanhos[2] + 1);
+    // Datas passadas são aceitas: a exportação inclui as estadias já feitas
+    if (linha->tamanhos[3] != 10 || !data_no_calendario(linha->campos[3])) {
+        snprintf(erro, tamanho_erro, "data inválida \"%s\" (DD/MM/AAAA, de 1900 a 2100)", linha->campos[3]);
+        return 0;
+    }
+    memcpy(reserva->data_inicio, linha->campos[3], 11);
+    if (!csv_ler_inteiro(linha->campos[4], &reserva->num_diarias) || reserva->num_diarias < 1) {
+        snprintf(erro, tamanho_erro, "número de diárias inválido \"%s\"", linha->campos[4]);
+        return 0;
+    }
+    if (!csv_ler_inteiro(linha->campos[5], &reserva->num_pessoas) || reserva->num_pessoas < 1) {
+        snprintf(erro, tamanho_erro, "número de pessoas inválido \"%s\"", linha->campos[5]);
+        return 0;
+    }
+    if (linha->num_campos == CSV_NUM_CAMPOS && linha->tamanhos[6] > 0) {
+        if (!csv_ler_preco(linha->campos[6], &reserva->preco)) {
+            snprintf(erro, tamanho_erro, "preço inválido \"%s\"", linha->campos[6]);
+            return 0;
+        }
+    } else {
+        reserva->preco = 0.0;  // Calculado pelas tarifas na inclusão do lote
+    }
+    reserva->inicio = parse_data_compacta(reserva->data_inicio);
+    return 1;
+}
+
+// Função para encerrar uma linha lida: valida e acrescenta a reserva ao lote
+static void csv_concluir_linha(LinhaCSV* linha, long numero_linha, LoteCSV* lote) {
+    for (int campo = 0; campo < CSV_NUM_CAMPOS; campo++) {
+        linha->campos[campo][linha->tamanhos[campo]] = '\0';
+    }
+
+    // Cabeçalho opcional: primeira linha sem número de quarto
+    int valor;
+    if (numero_linha == 1 && !csv_ler_inteiro(linha->campos[1], &valor)) {
+        return;
+    }
+
+    Reserva reserva;
+    char motivo[192];
+    if (!csv_linha_para_reserva(linha, &reserva, motivo, sizeof(motivo))) {
+        if (lote->erros < CSV_MAX_ERROS) {
+            printf("Linha %ld: %s\n", numero_linha, motivo);
+        }
+        lote->erros++;
+        return;
+    }
+
+    if (lote->tamanho == lote->capacidade) {
+        lote->capacidade = lote->capacidade ? lote->capacidade * 2 : 1024;
+        Reserva* reservas = (Reserva*) realloc(lote->reservas, (size_t) lote->capacidade * sizeof(Reserva));
+        long* linhas = (long*) realloc(lote->linhas, (size_t) lote->capacidade * sizeof(long));
+        if (reservas == NULL || linhas == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        lote->reservas = reservas;
+        lote->linhas = linhas;
+    }
+    lote->reservas[lote->tamanho] = reserva;
+    lote->linhas[lote->tamanho] = numero_linha;
+    lote->tamanho++;
+}
+
+// Função para importar reservas de um arquivo CSV. O arquivo é lido em blocos
+// de CSV_TAMANHO_BLOCO e cada campo é copiado direto para uma linha de
+// tamanho fixo, sem alocação por campo. A importação é tudo ou nada: se
+// alguma linha for inválida ou conflitar, nada é incluído. Ao contrário das
+// reservas novas, as datas podem ser passadas, para que qualquer arquivo de
+// exportarReservasCSV possa ser importado de volta. Retorna o número de
+// reservas importadas ou -1.
+long importarReservasCSV(MotorReservas* motor, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        printf("Erro ao abrir %s!\n", caminho);
+        return -1;
+    }
+    char* bloco = (char*) malloc(CSV_TAMANHO_BLOCO);
+    if (bloco == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+
+    LoteCSV lote = {NULL, NULL, 0, 0, 0};
+    LinhaCSV linha;
+    memset(&linha, 0, sizeof(linha));
+    long numero_linha = 1;
+    int entre_aspas = 0;
+    int aspas_pendente = 0;  // Leu '"' dentro de aspas: fim do texto ou aspas duplicadas
+    int linha_vazia = 1;
+    int fim_arquivo = 0;
+
+    for (;;) {
+        size_t lidos = fread(bloco, 1, CSV_TAMANHO_BLOCO, arquivo);
+        if (lidos == 0) {
+            if (ferror(arquivo)) {
+                printf("Erro ao ler %s!\n", caminho);
+                lote.erros++;
+                break;
+            }
+            if (linha_vazia || fim_arquivo) {
+                break;
+            }
+            // A última linha não terminou com quebra de linha
+            fim_arquivo = 1;
+            bloco[0] = '\n';
+            lidos = 1;
+        }
+
+        for (size_t i = 0; i < lidos; i++) {
+            char c = bloco[i];
+            int literal = 0;  // Caractere que pertence ao campo, mesmo sendo separador
+            if (aspas_pendente) {
+                aspas_pendente = 0;
+                if (c == '"') {
+                    literal = 1;  // Aspas duplicadas
+                } else {
+                    entre_aspas = 0;
+                }
+            } else if (entre_aspas) {
+                if (c == '"') {
+                    aspas_pendente = 1;
+                    continue;
+                }
+                literal = 1;
+            }
+
+            if (!literal) {
+                if (c == '"') {
+                    entre_aspas = 1;
+                    linha_vazia = 0;
+                    continue;
+                }
+                if (c == '\r') {
+                    continue;
+                }
+                if (c == ',') {
+                    linha.num_campos++;
+                    linha_vazia = 0;
+                    continue;
+                }
+                if (c == '\n') {
+                    if (!linha_vazia) {
+                        linha.num_campos++;
+                        csv_concluir_linha(&linha, numero_linha, &lote);
+                    }
+                    memset(&linha, 0, sizeof(linha));
+                    linha_vazia = 1;
+                    numero_linha++;
+                    continue;
+                }
+            }
+
+            linha_vazia = 0;
+            if (linha.num_campos < CSV_NUM_CAMPOS) {
+                int campo = linha.num_campos;
+                if (linha.tamanhos[campo] < CSV_TAMANHO_CAMPO - 1) {
+                    linha.campos[campo][linha.tamanhos[campo]++] = c;
+                } else {
+                    linha.truncada = 1;
+                }
+            }
+        }
+    }
+    fclose(arquivo);
+    free(bloco);
+
+    if (entre_aspas) {
+        printf("Linha %ld: aspas não fechadas\n", numero_linha);
+        lote.erros++;
+    }
+
+    // Valida os conflitos e inclui todas as reservas de uma vez
+    long importadas = -1;
+    if (lote.erros == 0) {
+        int* situacao = (int*) malloc((size_t) (lote.tamanho > 0 ? lote.tamanho : 1) * sizeof(int));
+        if (situacao == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        if (inserirReservasLote(motor, lote.reservas, lote.tamanho, situacao)) {
+            importadas = lote.tamanho;
+        } else {
+            for (long i = 0; i < lote.tamanho; i++) {
+                const char* motivo = NULL;
+                switch (situacao[i]) {
+                    case LOTE_CONFLITO_LOTE: motivo = "sobrepõe outra linha do arquivo"; break;
+                    case LOTE_CONFLITO_EXISTENTE: motivo = "já reservado no período"; break;
+                    case LOTE_QUARTO_INVALIDO: motivo = "o hotel não tem esse quarto"; break;
+                    case LOTE_CAPACIDADE: motivo = "excede a capacidade do quarto ou do hotel no período"; break;
+                    case LOTE_ERRO_DIARIO: motivo = "não foi gravado no diário"; break;
+                    case LOTE_OK: break;
+                    default: motivo = "reserva inválida"; break;
+                }
+                if (motivo != NULL) {
+                    if (lote.erros < CSV_MAX_ERROS) {
+                        printf("Linha %ld: quarto %d %s\n", lote.linhas[i], lote.reservas[i].quarto_id, motivo);
+                    }
+                    lote.erros++;
+                }
+            }
+        }
+        free(situacao);
+    }
+    if (lote.erros > CSV_MAX_ERROS) {
+        printf("... e mais %ld erro(s)\n", lote.erros - CSV_MAX_ERROS);
+    }
+    free(lote.reservas);
+    free(lote.linhas);
+    return importadas;
+}
+
+// Função para escrever um campo de texto entre aspas, duplicando as internas
+static void csv_escrever_texto(FILE* arquivo, const char* texto) {
+    fputc('"', arquivo);
+    for (const char* c = texto; *c != '\0'; c++) {
+        if (*c == '"') {
+            fputc('"', arquivo);
+        }
+        fputc(*c, arquivo);
+    }
+    fputc('"', arquivo);
+}
+
+// Função para exportar todas as reservas, em ordem de data, para um arquivo
+// CSV. Retorna o número de reservas exportadas ou -1.
+long exportarReservasCSV(MotorReservas* motor, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        printf("Erro ao gravar %s!\n", caminho);
+        return -1;
+    }
+    setvbuf(arquivo, NULL, _IOFBF, CSV_TAMANHO_BLOCO);
+
+    fputs("reserva_id,quarto_id,nome_cliente,data_inicio,num_diarias,num_pessoas,preco\n", arquivo);
+    long exportadas = 0;
+    pthread_rwlock_rdlock(&motor->trava);
+    for (No* temp = motor->saltos.cabeca[0]; temp != NULL; temp = temp->prox) {
+        const Reserva* reserva = &temp->reserva;
+        // Preço em centavos, para não depender do separador decimal da localidade
+        long long centavos = (long long) (reserva->preco * 100.0 + 0.5);
+        fprintf(arquivo, "%d,%d,", reserva->reserva_id, reserva->quarto_id);
+        csv_escrever_texto(arquivo, reserva->nome_cliente);
+        fprintf(arquivo, ",%s,%d,%d,%lld.%02lld\n", reserva->data_inicio, reserva->num_diarias,
+                reserva->num_pessoas, centavos / 100, centavos % 100);
+        exportadas++;
+    }
+    pthread_rwlock_unlock(&motor->trava);
+
+    int ok = !ferror(arquivo);
+    ok = (fclose(arquivo) == 0) && ok;
+    if (!ok) {
+        printf("Erro ao gravar %s!\n", caminho);
+        return -1;
+    }
+    return exportadas;
+}
+
@@ -0,0 +1,218 @@
+// motor_reservas.h
+// Motor de reservas sem interface: guarda as reservas de um hotel e oferece
+// inserção, remoção, busca, disponibilidade, persistência e importação.
+// Cada hotel é um MotorReservas independente; não há estado global, então
+// vários motores podem conviver no mesmo processo. Um motor pode ser usado
+// por várias threads ao mesmo tempo (ver "Concorrência" em motor_reservas.c).
+#ifndef MOTOR_RESERVAS_H
+#define MOTOR_RESERVAS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Definições e Estruturas
+#define QUARTOS_PADRAO 50      // Layout sem quartos.txt: quartos 1 a 50...
+#define CAPACIDADE_PADRAO 100  // ...e até 100 hóspedes por dia no hotel
+#define QUARTOS_MAX 100000
+#define PRECO_RESERVA 250.0 // Tarifa padrão por pessoa por diária (ver "Tarifas")
+#define TIPOS_QUARTO_MAX 16
+#define TEMPORADA_MAX_DIAS (366 * 10)
+#define DIARIAS_MAX 366  // Máximo de diárias de uma reserva
+
+// Arquivos padrão do snapshot e do diário
+#define ARQUIVO_RESERVAS "reservas.dat"
+#define ARQUIVO_DIARIO "reservas.wal"
+#define ARQUIVO_TARIFAS "tarifas.txt"
+#define ARQUIVO_QUARTOS "quartos.txt"
+#define DIARIO_JANELA_MS 20  // Janela de agrupamento do fsync
+
+// Data compacta: número de dias desde 01/01/1970
+typedef int32_t DataCompacta;
+#define DATA_INVALIDA INT32_MIN
+
+typedef struct {
+    int reserva_id;        // ID único da reserva
+    int quarto_id;         // ID do quarto
+    char nome_cliente[100];
+    char data_inicio[11];  // Formato DD/MM/AAAA
+    int num_diarias;
+    int num_pessoas;
+    double preco;
+    DataCompacta inicio;   // data_inicio em dias, calculada em inserirReserva
+} Reserva;
+
+// Motor e nós da lista ordenada por data são opacos; os nós são percorridos
+// com primeiroNo/proximoNo e lidos com reservaDoNo
+typedef struct MotorReservas MotorReservas;
+typedef struct No No;
+
+// Quarto do layout do hotel (carregarQuartos)
+typedef struct {
+    int numero;      // Número do quarto, usado em Reserva.quarto_id
+    int andar;
+    int tipo;        // Tipo de quarto das tarifas, de 0 a TIPOS_QUARTO_MAX - 1
+    int capacidade;  // Máximo de pessoas no quarto
+} Quarto;
+
+// Totais de um dia, mantidos a cada inserção e remoção
+typedef struct {
+    int hospedes;
+    int quartos_ocupados;
+    double receita;  // Soma das diárias do dia
+} AgregadoDia;
+
+typedef struct {
+    size_t nos_vivos;   // Nós em uso por reservas
+    size_t nos_livres;  // Nós reservados pelo pool e ainda não usados
+    size_t blocos;
+    size_t bytes;       // Memória total obtida do sistema
+} EstatisticasPool;
+
+// Colunas da tabela de reservas (obterColunasReservas): um vetor por campo,
+// indexados pela linha da reserva, para varreduras e agregações que leem só
+// os campos de que precisam. Linhas com reserva_id 0 estão livres: têm
+// início DATA_INVALIDA (ficam fora de qualquer período) e pessoas, diárias e
+// preço zerados.
+typedef struct {
+    long linhas;                 // Tamanho dos vetores
+    const int* reserva_id;
+    const int* quarto_id;
+    const int* posicao_quarto;   // Posição do quarto no layout (quartoNaPosicao); -1 se não existe
+    const DataCompacta* inicio;
+    const int* num_diarias;
+    const int* num_pessoas;
+    const double* preco;
+} ColunasReservas;
+
+// Contadores de reservarQuarto desde a criação do motor, para medir a
+// disputa por quartos
+typedef struct {
+    long tentativas;   // Pedidos com dados válidos
+    long aceitas;
+    long conflitos;    // Recusados por um dia já ocupado ou disputado
+    long repeticoes;   // Compare-and-swap refeitos por mudança em outro quarto
+    long desfeitas;    // Quartos reivindicados e devolvidos por falta de capacidade
+} EstatisticasDisputa;
+
+// Notificação de mudanças na lista de reservas, para que a interface
+// atualize apenas a linha afetada. 'posicao' é a posição (a partir de 0) do
+// nó na lista ordenada: a nova posição na inserção, a antiga na remoção.
+// Um lote (inserirReservasLote) gera uma EVENTO_INSERCAO por reserva, em
+// ordem crescente de posição, depois que todo o lote já está na lista.
+typedef enum {
+    EVENTO_INSERCAO,
+    EVENTO_REMOCAO
+} TipoEvento;
+
+typedef void (*ObservadorReservas)(TipoEvento tipo, No* no, int posicao, void* dados);
+
+// Situação de cada reserva após a validação de um lote (inserirReservasLote)
+// e resultado de reservarQuarto
+#define LOTE_OK 0
+#define LOTE_QUARTO_INVALIDO 1     // Quarto fora do layout do hotel
+#define LOTE_DADOS_INVALIDOS 2     // Data, diárias (1 a DIARIAS_MAX) ou pessoas inválidas
+#define LOTE_CONFLITO_LOTE 3       // Sobrepõe outra reserva do mesmo lote
+#define LOTE_CONFLITO_EXISTENTE 4  // Quarto já reservado no período
+#define LOTE_CAPACIDADE 5          // Excede a capacidade do quarto ou do hotel em algum dia
+#define LOTE_ERRO_DIARIO 6         // Não foi possível gravar no diário; nada foi alterado
+
+#define NOME_CHAVE_MAX 100  // Tamanho da chave gerada por normalizar_nome
+
+// Datas
+int isAnoBissexto(int ano);
+int diasNoMes(int mes, int ano);
+DataCompacta data_para_dias(int dia, int mes, int ano);
+void dias_para_data(DataCompacta dias, int* dia, int* mes, int* ano);
+DataCompacta parse_data_compacta(const char* data_str);
+void formatar_data_compacta(DataCompacta dias, char* data_str);
+DataCompacta data_hoje();
+int verificarDataValida(const char* data_str);
+int ranges_overlap(DataCompacta start1, int days1, DataCompacta start2, int days2);
+int normalizar_nome(const char* nome, char* chave);
+
+// Ciclo de vida
+MotorReservas* criarMotorReservas();
+void liberarMotorReservas(MotorReservas* motor);
+void liberarReservas(MotorReservas* motor);
+void definirObservadorReservas(MotorReservas* motor, ObservadorReservas observador, void* dados);
+
+// Operações
+// inserirReserva confere como reservarQuarto e retorna o id, ou 0 se recusada
+int inserirReserva(MotorReservas* motor, Reserva* nova_reserva);
+int reservarQuarto(MotorReservas* motor, Reserva* nova_reserva);
+// Tudo ou nada. Se o lote for incluído, completa reserva_id, inicio e preco
+// (se zerado) de cada reserva; se for recusado (retorno 0), 'reservas' não
+// é alterado e 'situacao' (se não for NULL) diz o motivo de cada uma.
+int inserirReservasLote(MotorReservas* motor, Reserva* reservas, long quantidade, int* situacao);
+// removerReserva retorna 1 se removeu, 0 se a reserva não existe e -1 se não
+// foi possível gravar a remoção no diário (a reserva continua)
+int removerReserva(MotorReservas* motor, int id);
+int buscarReserva(MotorReservas* motor, int id, Reserva* reserva);
+int buscarReservasPorNome(MotorReservas* motor, const char* nome, int prefixo, int** ids);
+
+// Layout do hotel: números, andares, tipos e capacidades dos quartos, em
+// qualquer quantidade até QUARTOS_MAX e com números quaisquer. Só pode ser
+// trocado enquanto o motor não tem reservas (antes de carregar o snapshot).
+// 'capacidade_total' é o limite de hóspedes por dia no hotel; 0 usa a soma
+// das capacidades. Os quartos ficam ordenados por número e a posição de cada
+// um (0 a contarQuartos - 1) é estável enquanto o layout não muda.
+int definirQuartos(MotorReservas* motor, const Quarto* quartos, int quantidade, int capacidade_total);
+int carregarQuartos(MotorReservas* motor, const char* caminho);
+int contarQuartos(MotorReservas* motor);
+int capacidadeHotel(MotorReservas* motor);
+int buscarQuarto(MotorReservas* motor, int numero, Quarto* quarto);
+int quartoNaPosicao(MotorReservas* motor, int posicao, Quarto* quarto);
+
+// Consultas de ocupação. quartosLivres retorna quantos quartos estão livres
+// em todo o período e escreve os números dos 'max' primeiros em 'numeros'.
+int isRoomAvailable(MotorReservas* motor, int room, DataCompacta new_start, int new_days);
+int quartosLivres(MotorReservas* motor, DataCompacta inicio, int dias, int* numeros, int max);
+AgregadoDia obterAgregadoDia(MotorReservas* motor, DataCompacta dia);
+int capacidadeDisponivel(MotorReservas* motor, DataCompacta inicio, int dias);
+
+// Percurso da lista em ordem de data. Com outras threads usando o motor, os
+// nós só podem ser usados entre travarLeituraReservas e destravarLeituraReservas.
+int contarReservas(MotorReservas* motor);
+void travarLeituraReservas(MotorReservas* motor);
+void destravarLeituraReservas(MotorReservas* motor);
+No* primeiroNo(MotorReservas* motor);
+No* proximoNo(const No* no);
+No* noAnterior(const No* no);
+const Reserva* reservaDoNo(const No* no);
+No* noNaPosicao(MotorReservas* motor, int indice);
+int posicaoDoNo(MotorReservas* motor, const No* no);
+EstatisticasPool obterEstatisticasPool(MotorReservas* motor);
+EstatisticasDisputa obterEstatisticasDisputa(MotorReservas* motor);
+
+// Acesso em colunas. A linha de uma reserva não muda enquanto ela existir.
+// Os ponteiros valem até a próxima alteração; com outras threads usando o
+// motor, só entre travarLeituraReservas e destravarLeituraReservas.
+long linhaDoNo(const No* no);
+ColunasReservas obterColunasReservas(MotorReservas* motor);
+const char* nomeDaLinha(MotorReservas* motor, long linha);
+
+// Tarifas por pessoa por diária, por tipo de quarto (Quarto.tipo): uma base,
+// um fator por dia da semana (0 = domingo) e temporadas com tarifa própria
+// (0 volta à base). Todos os tipos começam com base PRECO_RESERVA. O preço
+// de uma reserva é calculado na inclusão, em O(1) para qualquer número de
+// diárias, e não muda com alterações posteriores.
+int definirTarifaBase(MotorReservas* motor, int tipo, double tarifa);
+int definirFatorSemana(MotorReservas* motor, int tipo, int dia, double fator);
+int definirTarifaTemporada(MotorReservas* motor, int tipo, DataCompacta inicio, int dias, double tarifa);
+double calcularPreco(MotorReservas* motor, int quarto, DataCompacta inicio, int dias, int pessoas);
+int carregarTarifas(MotorReservas* motor, const char* caminho);
+
+// Persistência
+int carregarReservas(MotorReservas* motor, const char* caminho);
+int salvarReservas(MotorReservas* motor, const char* caminho);
+long diario_reproduzir(MotorReservas* motor, const char* caminho);
+int diario_abrir(MotorReservas* motor, const char* caminho, const char* caminho_snapshot, int janela_ms);
+int diario_sincronizar(MotorReservas* motor);
+int diario_compactar(MotorReservas* motor);
+void diario_fechar(MotorReservas* motor);
+
+// Importação e exportação em CSV
+long importarReservasCSV(MotorReservas* motor, const char* caminho);
+long exportarReservasCSV(MotorReservas* motor, const char* caminho);
+
+#endif
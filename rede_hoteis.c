@@ -0,0 +1,478 @@
+// rede_hoteis.c
+// Implementação da rede de hotéis (ver rede_hoteis.h)
+#include "rede_hoteis.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define REDE_CAMINHO_MAX 1024
+#define REDE_MAX_THREADS 64
+
+// Trabalho do conjunto de threads: executa funcao(dados, i) para cada i em
+// [0, total). As threads tiram o próximo índice da fila; quem enviou o
+// trabalho também executa índices enquanto houver e depois espera os que
+// estão com as outras threads.
+typedef struct Trabalho {
+    void (*funcao)(void* dados, int indice);
+    void* dados;
+    int total;
+    int proximo;         // Próximo índice a executar
+    int pendentes;       // Índices ainda não concluídos
+    struct Trabalho* prox;
+} Trabalho;
+
+typedef struct {
+    pthread_t threads[REDE_MAX_THREADS];
+    int num_threads;
+    pthread_mutex_t trava;
+    pthread_cond_t tem_trabalho;
+    pthread_cond_t concluido;
+    Trabalho* fila;
+    Trabalho* fila_fim;
+    int encerrar;
+} ConjuntoThreads;
+
+typedef struct {
+    char codigo[REDE_CODIGO_MAX];
+    MotorReservas* motor;
+} Hotel;
+
+struct RedeHoteis {
+    Hotel hoteis[REDE_MAX_HOTEIS];
+    int num_hoteis;
+    ConjuntoThreads threads;
+};
+
+// Função para tirar o próximo índice do primeiro trabalho da fila (com a
+// trava); retira o trabalho da fila quando ele não tem mais índices
+static Trabalho* conjunto_proximo(ConjuntoThreads* conjunto, int* indice) {
+    Trabalho* trabalho = conjunto->fila;
+    *indice = trabalho->proximo++;
+    if (trabalho->proximo == trabalho->total) {
+        conjunto->fila = trabalho->prox;
+        if (conjunto->fila == NULL) {
+            conjunto->fila_fim = NULL;
+        }
+    }
+    return trabalho;
+}
+
+// Função para executar um índice fora da trava e registrar a conclusão
+static void conjunto_executar(ConjuntoThreads* conjunto, Trabalho* trabalho, int indice) {
+    trabalho->funcao(trabalho->dados, indice);
+    pthread_mutex_lock(&conjunto->trava);
+    if (--trabalho->pendentes == 0) {
+        pthread_cond_broadcast(&conjunto->concluido);
+    }
+    pthread_mutex_unlock(&conjunto->trava);
+}
+
+static void* conjunto_atender(void* arg) {
+    ConjuntoThreads* conjunto = (ConjuntoThreads*) arg;
+    pthread_mutex_lock(&conjunto->trava);
+    for (;;) {
+        while (conjunto->fila == NULL && !conjunto->encerrar) {
+            pthread_cond_wait(&conjunto->tem_trabalho, &conjunto->trava);
+        }
+        if (conjunto->fila == NULL) {
+            break;
+        }
+        int indice;
+        Trabalho* trabalho = conjunto_proximo(conjunto, &indice);
+        pthread_mutex_unlock(&conjunto->trava);
+        conjunto_executar(conjunto, trabalho, indice);
+        pthread_mutex_lock(&conjunto->trava);
+    }
+    pthread_mutex_unlock(&conjunto->trava);
+    return NULL;
+}
+
+// Função para executar funcao(dados, i) para i em [0, total) nas threads do
+// conjunto e na thread que chamou; retorna quando todos terminarem
+static void conjunto_paralelo(ConjuntoThreads* conjunto, void (*funcao)(void*, int), void* dados, int total) {
+    if (total <= 0) {
+        return;
+    }
+    Trabalho trabalho = {funcao, dados, total, 0, total, NULL};
+    pthread_mutex_lock(&conjunto->trava);
+    if (conjunto->fila_fim != NULL)
+        conjunto->fila_fim->prox = &trabalho;
+    else
+        conjunto->fila = &trabalho;
+    conjunto->fila_fim = &trabalho;
+    pthread_cond_broadcast(&conjunto->tem_trabalho);
+
+    // Ajuda no próprio trabalho enquanto ele ainda tiver índices na fila
+    while (trabalho.proximo < trabalho.total) {
+        Trabalho* anterior = NULL;
+        for (Trabalho* t = conjunto->fila; t != &trabalho; t = t->prox) {
+            anterior = t;
+        }
+        int indice = trabalho.proximo++;
+        if (trabalho.proximo == trabalho.total) {
+            if (anterior != NULL)
+                anterior->prox = trabalho.prox;
+            else
+                conjunto->fila = trabalho.prox;
+            if (conjunto->fila_fim == &trabalho) {
+                conjunto->fila_fim = anterior;
+            }
+        }
+        pthread_mutex_unlock(&conjunto->trava);
+        conjunto_executar(conjunto, &trabalho, indice);
+        pthread_mutex_lock(&conjunto->trava);
+    }
+    while (trabalho.pendentes > 0) {
+        pthread_cond_wait(&conjunto->concluido, &conjunto->trava);
+    }
+    pthread_mutex_unlock(&conjunto->trava);
+}
+
+static int processadores() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int) info.dwNumberOfProcessors;
+#else
+    return (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+// Função para criar uma rede vazia. A thread que faz uma consulta também
+// trabalha nela, então o conjunto tem threads - 1 threads próprias.
+RedeHoteis* criarRedeHoteis(int threads) {
+    RedeHoteis* rede = (RedeHoteis*) calloc(1, sizeof(RedeHoteis));
+    if (rede == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    if (threads <= 0) {
+        threads = processadores();
+    }
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > REDE_MAX_THREADS) {
+        threads = REDE_MAX_THREADS;
+    }
+
+    ConjuntoThreads* conjunto = &rede->threads;
+    pthread_mutex_init(&conjunto->trava, NULL);
+    pthread_cond_init(&conjunto->tem_trabalho, NULL);
+    pthread_cond_init(&conjunto->concluido, NULL);
+    for (int i = 0; i < threads - 1; i++) {
+        if (pthread_create(&conjunto->threads[i], NULL, conjunto_atender, conjunto) != 0) {
+            break;  // Segue com as threads que conseguiu criar
+        }
+        conjunto->num_threads++;
+    }
+    return rede;
+}
+
+void liberarRedeHoteis(RedeHoteis* rede) {
+    if (rede == NULL) {
+        return;
+    }
+    ConjuntoThreads* conjunto = &rede->threads;
+    pthread_mutex_lock(&conjunto->trava);
+    conjunto->encerrar = 1;
+    pthread_cond_broadcast(&conjunto->tem_trabalho);
+    pthread_mutex_unlock(&conjunto->trava);
+    for (int i = 0; i < conjunto->num_threads; i++) {
+        pthread_join(conjunto->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&conjunto->trava);
+    pthread_cond_destroy(&conjunto->tem_trabalho);
+    pthread_cond_destroy(&conjunto->concluido);
+
+    for (int i = 0; i < rede->num_hoteis; i++) {
+        liberarMotorReservas(rede->hoteis[i].motor);
+    }
+    free(rede);
+}
+
+// Função para validar um código de hotel: de 1 a REDE_CODIGO_MAX - 1
+// caracteres, sem espaços nem ':' (usado nas respostas do servidor)
+static int codigo_valido(const char* codigo) {
+    size_t tamanho = strlen(codigo);
+    if (tamanho == 0 || tamanho >= REDE_CODIGO_MAX) {
+        return 0;
+    }
+    for (size_t i = 0; i < tamanho; i++) {
+        if (codigo[i] == ' ' || codigo[i] == '\t' || codigo[i] == ':') {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int adicionarHotel(RedeHoteis* rede, const char* codigo, MotorReservas* motor) {
+    if (motor == NULL || !codigo_valido(codigo) || rede->num_hoteis == REDE_MAX_HOTEIS ||
+        buscarHotel(rede, codigo) >= 0) {
+        return -1;
+    }
+    Hotel* hotel = &rede->hoteis[rede->num_hoteis];
+    strcpy(hotel->codigo, codigo);
+    hotel->motor = motor;
+    return rede->num_hoteis++;
+}
+
+int abrirHotel(RedeHoteis* rede, const char* codigo, const char* pasta) {
+    if (!codigo_valido(codigo) || buscarHotel(rede, codigo) >= 0) {
+        printf("Código de hotel inválido ou repetido: %s\n", codigo);
+        return -1;
+    }
+    if (rede->num_hoteis == REDE_MAX_HOTEIS) {
+        printf("A rede pode ter no máximo %d hotéis.\n", REDE_MAX_HOTEIS);
+        return -1;
+    }
+
+    char quartos[REDE_CAMINHO_MAX], tarifas[REDE_CAMINHO_MAX];
+    char reservas[REDE_CAMINHO_MAX], diario[REDE_CAMINHO_MAX];
+    int tamanho = snprintf(quartos, sizeof(quartos), "%s/%s", pasta, ARQUIVO_QUARTOS);
+    snprintf(tarifas, sizeof(tarifas), "%s/%s", pasta, ARQUIVO_TARIFAS);
+    snprintf(reservas, sizeof(reservas), "%s/%s", pasta, ARQUIVO_RESERVAS);
+    snprintf(diario, sizeof(diario), "%s/%s", pasta, ARQUIVO_DIARIO);
+    if (tamanho < 0 || tamanho + 16 >= REDE_CAMINHO_MAX) {
+        printf("Caminho muito longo: %s\n", pasta);
+        return -1;
+    }
+
+    MotorReservas* motor = criarMotorReservas();
+    const char* erro = NULL;
+    if (carregarQuartos(motor, quartos) < 0) {
+        erro = quartos;
+    } else if (carregarTarifas(motor, tarifas) < 0) {
+        erro = tarifas;
+    } else if (carregarReservas(motor, reservas) < 0) {
+        erro = reservas;
+    } else if (diario_reproduzir(motor, diario) < 0 || !diario_abrir(motor, diario, reservas, DIARIO_JANELA_MS)) {
+        erro = diario;
+    }
+    if (erro != NULL) {
+        printf("Hotel %s: o arquivo %s é inválido ou não pôde ser aberto.\n", codigo, erro);
+        liberarMotorReservas(motor);
+        return -1;
+    }
+    return adicionarHotel(rede, codigo, motor);
+}
+
+int carregarRede(RedeHoteis* rede, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    int abertos = 0;
+    long numero_linha = 0;
+    char linha[REDE_CAMINHO_MAX + REDE_CODIGO_MAX + 8];
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        char* comentario = strchr(linha, '#');
+        if (comentario != NULL) {
+            *comentario = '\0';
+        }
+        linha[strcspn(linha, "\r\n")] = '\0';
+        char codigo[REDE_CODIGO_MAX + 1];
+        int lidos;
+        if (sscanf(linha, " %16s %n", codigo, &lidos) < 1) {
+            continue;
+        }
+        char* pasta = linha + lidos;
+        size_t tamanho = strlen(pasta);
+        while (tamanho > 0 && (pasta[tamanho - 1] == ' ' || pasta[tamanho - 1] == '\t')) {
+            pasta[--tamanho] = '\0';
+        }
+        if (tamanho == 0) {
+            printf("%s, linha %ld: use <código> <pasta>\n", caminho, numero_linha);
+            fclose(arquivo);
+            return -1;
+        }
+        if (abrirHotel(rede, codigo, pasta) < 0) {
+            printf("%s, linha %ld: hotel não aberto\n", caminho, numero_linha);
+            fclose(arquivo);
+            return -1;
+        }
+        abertos++;
+    }
+    fclose(arquivo);
+    return abertos;
+}
+
+int contarHoteis(RedeHoteis* rede) {
+    return rede->num_hoteis;
+}
+
+// Função para encontrar o hotel pelo código; as redes têm poucas dezenas
+// de hotéis, então a busca é linear
+int buscarHotel(RedeHoteis* rede, const char* codigo) {
+    for (int i = 0; i < rede->num_hoteis; i++) {
+        if (strcmp(rede->hoteis[i].codigo, codigo) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char* codigoDoHotel(RedeHoteis* rede, int hotel) {
+    return hotel >= 0 && hotel < rede->num_hoteis ? rede->hoteis[hotel].codigo : NULL;
+}
+
+MotorReservas* motorDoHotel(RedeHoteis* rede, int hotel) {
+    return hotel >= 0 && hotel < rede->num_hoteis ? rede->hoteis[hotel].motor : NULL;
+}
+
+int reservarNaRede(RedeHoteis* rede, int hotel, Reserva* nova_reserva) {
+    MotorReservas* motor = motorDoHotel(rede, hotel);
+    return motor != NULL ? reservarQuarto(motor, nova_reserva) : -1;
+}
+
+int removerNaRede(RedeHoteis* rede, int hotel, int id) {
+    MotorReservas* motor = motorDoHotel(rede, hotel);
+    return motor != NULL ? removerReserva(motor, id) : 0;
+}
+
+int buscarNaRede(RedeHoteis* rede, int hotel, int id, Reserva* reserva) {
+    MotorReservas* motor = motorDoHotel(rede, hotel);
+    return motor != NULL && buscarReserva(motor, id, reserva);
+}
+
+// Tarefa de executarNaRede: adapta TarefaHotel ao índice do conjunto
+typedef struct {
+    RedeHoteis* rede;
+    TarefaHotel tarefa;
+    void* dados;
+} TarefaRede;
+
+static void executar_hotel(void* dados, int hotel) {
+    TarefaRede* t = (TarefaRede*) dados;
+    t->tarefa(t->rede->hoteis[hotel].motor, hotel, t->dados);
+}
+
+void executarNaRede(RedeHoteis* rede, TarefaHotel tarefa, void* dados) {
+    TarefaRede t = {rede, tarefa, dados};
+    conjunto_paralelo(&rede->threads, executar_hotel, &t, rede->num_hoteis);
+}
+
+// Busca de hóspede: cada hotel preenche a sua lista e as listas são
+// reunidas e ordenadas no final
+typedef struct {
+    const char* nome;
+    int prefixo;
+    ReservaRede** encontradas;  // Uma lista por hotel
+    int* quantidades;
+} BuscaHospede;
+
+static void buscar_hospede_no_hotel(MotorReservas* motor, int hotel, void* dados) {
+    BuscaHospede* busca = (BuscaHospede*) dados;
+    int* ids;
+    int total = buscarReservasPorNome(motor, busca->nome, busca->prefixo, &ids);
+    ReservaRede* lista = (ReservaRede*) malloc((size_t) (total > 0 ? total : 1) * sizeof(ReservaRede));
+    if (lista == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    int quantidade = 0;
+    for (int i = 0; i < total; i++) {
+        // A reserva pode ter sido removida depois da busca pelo nome
+        if (buscarReserva(motor, ids[i], &lista[quantidade].reserva)) {
+            lista[quantidade++].hotel = hotel;
+        }
+    }
+    free(ids);
+    busca->encontradas[hotel] = lista;
+    busca->quantidades[hotel] = quantidade;
+}
+
+// Comparação por data de início, hotel e id
+static int comparar_reserva_rede(const void* a, const void* b) {
+    const ReservaRede* ra = (const ReservaRede*) a;
+    const ReservaRede* rb = (const ReservaRede*) b;
+    if (ra->reserva.inicio != rb->reserva.inicio) {
+        return ra->reserva.inicio < rb->reserva.inicio ? -1 : 1;
+    }
+    if (ra->hotel != rb->hotel) {
+        return ra->hotel < rb->hotel ? -1 : 1;
+    }
+    return (ra->reserva.reserva_id > rb->reserva.reserva_id) - (ra->reserva.reserva_id < rb->reserva.reserva_id);
+}
+
+int buscarHospedeNaRede(RedeHoteis* rede, const char* nome, int prefixo, ReservaRede** reservas) {
+    int n = rede->num_hoteis;
+    BuscaHospede busca;
+    busca.nome = nome;
+    busca.prefixo = prefixo;
+    busca.encontradas = (ReservaRede**) calloc((size_t) (n > 0 ? n : 1), sizeof(ReservaRede*));
+    busca.quantidades = (int*) calloc((size_t) (n > 0 ? n : 1), sizeof(int));
+    if (busca.encontradas == NULL || busca.quantidades == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    executarNaRede(rede, buscar_hospede_no_hotel, &busca);
+
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        total += busca.quantidades[i];
+    }
+    ReservaRede* todas = (ReservaRede*) malloc((size_t) (total > 0 ? total : 1) * sizeof(ReservaRede));
+    if (todas == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        memcpy(&todas[k], busca.encontradas[i], (size_t) busca.quantidades[i] * sizeof(ReservaRede));
+        k += busca.quantidades[i];
+        free(busca.encontradas[i]);
+    }
+    free(busca.encontradas);
+    free(busca.quantidades);
+    qsort(todas, (size_t) total, sizeof(ReservaRede), comparar_reserva_rede);
+    *reservas = todas;
+    return total;
+}
+
+// Receita do grupo: cada hotel soma as suas colunas (totalizarReservas)
+typedef struct {
+    DataCompacta de;
+    DataCompacta ate;
+    TotaisReservas* por_hotel;
+} ReceitaRede;
+
+static void totalizar_hotel(MotorReservas* motor, int hotel, void* dados) {
+    ReceitaRede* receita = (ReceitaRede*) dados;
+    receita->por_hotel[hotel] = totalizarReservas(motor, receita->de, receita->ate);
+}
+
+TotaisReservas totalizarRede(RedeHoteis* rede, DataCompacta de, DataCompacta ate, TotaisReservas* por_hotel) {
+    int n = rede->num_hoteis;
+    ReceitaRede receita;
+    receita.de = de;
+    receita.ate = ate;
+    receita.por_hotel = por_hotel;
+    if (por_hotel == NULL) {
+        receita.por_hotel = (TotaisReservas*) malloc((size_t) (n > 0 ? n : 1) * sizeof(TotaisReservas));
+        if (receita.por_hotel == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+    }
+    executarNaRede(rede, totalizar_hotel, &receita);
+
+    TotaisReservas total = {0, 0, 0, 0.0};
+    for (int i = 0; i < n; i++) {
+        total.reservas += receita.por_hotel[i].reservas;
+        total.pessoas += receita.por_hotel[i].pessoas;
+        total.diarias += receita.por_hotel[i].diarias;
+        total.receita += receita.por_hotel[i].receita;
+    }
+    if (por_hotel == NULL) {
+        free(receita.por_hotel);
+    }
+    return total;
+}
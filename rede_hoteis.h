@@ -0,0 +1,78 @@
+// rede_hoteis.h
+// Rede de hotéis: cada hotel (propriedade) tem o seu próprio motor de
+// reservas, com reservas, layout, tarifas e arquivos independentes. A rede
+// encaminha inclusão, remoção e busca ao motor do hotel e executa as
+// consultas da rede inteira (hóspede em qualquer hotel, receita do grupo)
+// em paralelo, um hotel por tarefa, num conjunto fixo de threads; os
+// resultados de cada hotel são reunidos no final.
+//
+// Os hotéis são adicionados ao abrir a rede, antes de ela ser usada por
+// várias threads; depois disso todas as funções podem ser chamadas de
+// qualquer thread (cada motor faz a sua própria sincronização).
+#ifndef REDE_HOTEIS_H
+#define REDE_HOTEIS_H
+
+#include "motor_reservas.h"
+#include "analise_reservas.h"
+
+#define REDE_MAX_HOTEIS 256
+#define REDE_CODIGO_MAX 16    // Tamanho do código do hotel, com o '\0'
+#define ARQUIVO_HOTEIS "hoteis.txt"
+
+typedef struct RedeHoteis RedeHoteis;
+
+// Reserva encontrada numa consulta da rede; 'hotel' é o índice do hotel
+typedef struct {
+    int hotel;
+    Reserva reserva;
+} ReservaRede;
+
+// Cria uma rede vazia com 'threads' threads para as consultas (0 = uma por
+// processador). liberarRedeHoteis libera também os motores dos hotéis.
+RedeHoteis* criarRedeHoteis(int threads);
+void liberarRedeHoteis(RedeHoteis* rede);
+
+// Adiciona um hotel com o motor dado (a rede passa a ser dona dele).
+// Retorna o índice do hotel ou -1 se o código for inválido ou repetido ou
+// se a rede estiver cheia.
+int adicionarHotel(RedeHoteis* rede, const char* codigo, MotorReservas* motor);
+
+// Abre um hotel a partir da sua pasta, com os mesmos arquivos de um hotel
+// sozinho (ARQUIVO_QUARTOS, ARQUIVO_TARIFAS, ARQUIVO_RESERVAS e
+// ARQUIVO_DIARIO, com o diário aberto). Retorna o índice ou -1 (o motivo é
+// informado na saída padrão).
+int abrirHotel(RedeHoteis* rede, const char* codigo, const char* pasta);
+
+// Abre os hotéis listados num arquivo, uma linha "<código> <pasta>" por
+// hotel ('#' inicia um comentário). Retorna quantos hotéis foram abertos,
+// 0 se o arquivo não existir e -1 se ele ou algum hotel for inválido.
+int carregarRede(RedeHoteis* rede, const char* caminho);
+
+int contarHoteis(RedeHoteis* rede);
+int buscarHotel(RedeHoteis* rede, const char* codigo);  // Índice ou -1
+const char* codigoDoHotel(RedeHoteis* rede, int hotel);
+MotorReservas* motorDoHotel(RedeHoteis* rede, int hotel);  // NULL fora da faixa
+
+// Encaminhamento ao hotel. reservarNaRede e removerNaRede retornam o
+// resultado de reservarQuarto e removerReserva; se o hotel não existir,
+// reservarNaRede retorna -1 e as outras retornam 0.
+int reservarNaRede(RedeHoteis* rede, int hotel, Reserva* nova_reserva);
+int removerNaRede(RedeHoteis* rede, int hotel, int id);
+int buscarNaRede(RedeHoteis* rede, int hotel, int id, Reserva* reserva);
+
+// Executa tarefa(motor, hotel, dados) para cada hotel, em paralelo, e
+// retorna quando todas terminarem. A tarefa escreve só na sua parte de
+// 'dados' (por exemplo, dados[hotel]).
+typedef void (*TarefaHotel)(MotorReservas* motor, int hotel, void* dados);
+void executarNaRede(RedeHoteis* rede, TarefaHotel tarefa, void* dados);
+
+// Reservas de um hóspede em todos os hotéis (nome completo ou, com
+// 'prefixo', início do nome), ordenadas por data de início. Retorna a
+// quantidade em *reservas, que deve ser liberado pelo chamador.
+int buscarHospedeNaRede(RedeHoteis* rede, const char* nome, int prefixo, ReservaRede** reservas);
+
+// Totais do grupo das reservas com início em [de, ate). Se 'por_hotel' não
+// for NULL (contarHoteis itens), recebe os totais de cada hotel.
+TotaisReservas totalizarRede(RedeHoteis* rede, DataCompacta de, DataCompacta ate, TotaisReservas* por_hotel);
+
+#endif
@@ -0,0 +1,842 @@
+// servidor_reservas.c
+// Servidor de reservas: atende outros sistemas (channel managers, totens) por
+// um socket TCP local ou Unix, com um protocolo de linhas de texto. Um único
+// processo atende todas as conexões com E/S não bloqueante (epoll no Linux,
+// poll nos demais sistemas POSIX).
+//
+// No Linux, várias threads esperam no mesmo epoll e cada descritor é
+// registrado com EPOLLONESHOT: uma conexão é atendida por uma thread de cada
+// vez e só volta ao laço quando essa thread termina, então as respostas de
+// uma conexão continuam na ordem dos pedidos. O motor faz a sua própria
+// sincronização. Com poll o servidor usa uma thread só.
+//
+// Com --hoteis o servidor atende uma rede de hotéis (rede_hoteis.h), cada um
+// com a sua pasta de arquivos; sem a opção há um só hotel, "principal", com
+// os arquivos da pasta atual. Cada conexão começa no primeiro hotel e troca
+// com HOTEL; os pedidos REDE_* consultam todos os hotéis em paralelo.
+//
+// Uso: servidor_reservas --tcp PORTA | --unix CAMINHO [--threads N] [--hoteis ARQUIVO]
+//      (N padrão: um por processador)
+//
+// Cada pedido é uma linha; cada resposta é uma linha começando por "OK" ou
+// "ERRO <motivo>". Vários pedidos podem ser enviados sem esperar as respostas,
+// que chegam na mesma ordem; quem acumula mais de SERVIDOR_MAX_SAIDA bytes de
+// respostas sem lê-las é desconectado, e uma linha maior que
+// SERVIDOR_MAX_LINHA recebe "ERRO linha_longa" e encerra a conexão. As
+// <diarias> vão de 1 a DIARIAS_MAX; acima disso a resposta é
+// "ERRO dados_invalidos". NOME e REDE_NOME com mais de
+// SERVIDOR_MAX_RESULTADOS reservas respondem "ERRO muitos_resultados" (use
+// um início de nome mais longo), para que uma resposta sozinha não passe de
+// SERVIDOR_MAX_SAIDA.
+//
+//   INSERIR <quarto> <DD/MM/AAAA> <diarias> <pessoas> <nome do cliente>
+//       OK <reserva_id> <preco>
+//   REMOVER <reserva_id>                      OK
+//   BUSCAR <reserva_id>
+//       OK <reserva_id> <quarto> <data> <diarias> <pessoas> <preco> <nome>
+//   NOME <início do nome>                     OK <quantidade> <ids...>
+//   DISPONIVEL <quarto> <DD/MM/AAAA> <diarias> OK 1 (livre) ou OK 0
+//   LIVRES <DD/MM/AAAA> <diarias>             OK <quantidade> <quartos...>
+//   PRECO <quarto> <DD/MM/AAAA> <diarias> <pessoas>
+//       OK <preco> (pelas tarifas em vigor, sem reservar)
+//   DISPUTA
+//       OK <tentativas> <aceitas> <conflitos> <repeticoes> <desfeitas>
+//   HOTEL <código>                            OK (pedidos seguintes vão a esse hotel)
+//   HOTEIS                                    OK <quantidade> <códigos...>
+//   REDE_NOME <início do nome>                OK <quantidade> <código>:<reserva_id>...
+//       (em todos os hotéis, por data de entrada)
+//   REDE_RECEITA <DD/MM/AAAA> <DD/MM/AAAA>    OK <reservas> <diarias> <receita>
+//       (reservas de todos os hotéis com entrada entre as duas datas, inclusive)
+//   SAIR                                      fecha a conexão
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/epoll.h>
+#define EVENTO_LEITURA EPOLLIN
+#define EVENTO_ESCRITA EPOLLOUT
+#define EVENTO_FIM (EPOLLHUP | EPOLLERR)
+#define SERVIDOR_MAX_THREADS 64
+#else
+#include <poll.h>
+#define EVENTO_LEITURA POLLIN
+#define EVENTO_ESCRITA POLLOUT
+#define EVENTO_FIM (POLLHUP | POLLERR)
+#endif
+#include "motor_reservas.h"
+#include "rede_hoteis.h"
+
+#define SERVIDOR_MAX_LINHA 512      // Pedidos maiores encerram a conexão
+#define SERVIDOR_MAX_SAIDA (4 << 20) // Respostas não lidas acima disto também
+#define SERVIDOR_MAX_RESULTADOS 10000 // Reservas numa resposta de NOME ou REDE_NOME
+#define SERVIDOR_MAX_EVENTOS 256
+#define SERVIDOR_TAMANHO_LEITURA 16384
+
+// Buffer de bytes que cresce conforme necessário
+typedef struct {
+    char* dados;
+    size_t tamanho;
+    size_t capacidade;
+} Buffer;
+
+typedef struct {
+    int fd;
+    Buffer entrada;     // Bytes recebidos e ainda não processados
+    Buffer saida;       // Respostas ainda não enviadas
+    size_t enviado;     // Quanto de 'saida' já foi enviado
+    int fechar;         // Fechar depois de enviar a saída pendente
+    int hotel;          // Hotel dos pedidos (índice na rede)
+#ifndef __linux__
+    int indice;         // Posição em laco_fds
+#endif
+} Conexao;
+
+// Variáveis Globais
+RedeHoteis* rede = NULL;
+atomic_int encerrar = 0;  // Lido por todas as threads, escrito no tratador de sinal
+
+// Laço de eventos: epoll no Linux, poll nos demais
+#ifdef __linux__
+int laco_fd = -1;
+#else
+struct pollfd* laco_fds = NULL;
+Conexao** laco_conexoes = NULL;  // Paralelo a laco_fds; NULL é o socket de escuta
+int laco_tamanho = 0;
+int laco_capacidade = 0;
+#endif
+
+// Função para garantir espaço para mais 'extra' bytes no buffer
+void buffer_reservar(Buffer* buffer, size_t extra) {
+    if (buffer->tamanho + extra <= buffer->capacidade) {
+        return;
+    }
+    size_t capacidade = buffer->capacidade ? buffer->capacidade : 1024;
+    while (capacidade < buffer->tamanho + extra) {
+        capacidade *= 2;
+    }
+    char* dados = (char*) realloc(buffer->dados, capacidade);
+    if (dados == NULL) {
+        printf("Erro de alocação de memória!\n");
+        exit(1);
+    }
+    buffer->dados = dados;
+    buffer->capacidade = capacidade;
+}
+
+// Função para acrescentar texto formatado ao buffer
+void buffer_printf(Buffer* buffer, const char* formato, ...) __attribute__((format(printf, 2, 3)));
+
+void buffer_printf(Buffer* buffer, const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(buffer->dados + buffer->tamanho, buffer->capacidade - buffer->tamanho, formato, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    if ((size_t) n >= buffer->capacidade - buffer->tamanho) {
+        buffer_reservar(buffer, (size_t) n + 1);
+        va_start(args, formato);
+        vsnprintf(buffer->dados + buffer->tamanho, buffer->capacidade - buffer->tamanho, formato, args);
+        va_end(args);
+    }
+    buffer->tamanho += (size_t) n;
+}
+
+// Função para colocar um descritor em modo não bloqueante
+int definir_nao_bloqueante(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Função para registrar um descritor no laço; 'conexao' NULL é o socket de escuta.
+// No epoll o descritor fica desarmado depois de cada evento, até laco_rearmar.
+void laco_adicionar(int fd, Conexao* conexao) {
+#ifdef __linux__
+    struct epoll_event evento = {0};
+    evento.events = EVENTO_LEITURA | EPOLLONESHOT;
+    evento.data.ptr = conexao;
+    if (epoll_ctl(laco_fd, EPOLL_CTL_ADD, fd, &evento) != 0) {
+        perror("epoll_ctl");
+    }
+#else
+    if (laco_tamanho == laco_capacidade) {
+        laco_capacidade = laco_capacidade ? laco_capacidade * 2 : 64;
+        laco_fds = (struct pollfd*) realloc(laco_fds, (size_t) laco_capacidade * sizeof(struct pollfd));
+        laco_conexoes = (Conexao**) realloc(laco_conexoes, (size_t) laco_capacidade * sizeof(Conexao*));
+        if (laco_fds == NULL || laco_conexoes == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+    }
+    laco_fds[laco_tamanho].fd = fd;
+    laco_fds[laco_tamanho].events = EVENTO_LEITURA;
+    laco_fds[laco_tamanho].revents = 0;
+    laco_conexoes[laco_tamanho] = conexao;
+    if (conexao != NULL) {
+        conexao->indice = laco_tamanho;
+    }
+    laco_tamanho++;
+#endif
+}
+
+// Função para devolver um descritor ao laço depois de atendido, pedindo
+// também o aviso de que o socket aceita escrita quando 'escrever' = 1
+void laco_rearmar(int fd, Conexao* conexao, int escrever) {
+#ifdef __linux__
+    struct epoll_event evento = {0};
+    evento.events = (escrever ? EVENTO_LEITURA | EVENTO_ESCRITA : EVENTO_LEITURA) | EPOLLONESHOT;
+    evento.data.ptr = conexao;
+    epoll_ctl(laco_fd, EPOLL_CTL_MOD, fd, &evento);
+#else
+    (void) fd;
+    if (conexao != NULL) {
+        laco_fds[conexao->indice].events = escrever ? EVENTO_LEITURA | EVENTO_ESCRITA : EVENTO_LEITURA;
+    }
+#endif
+}
+
+void laco_remover(Conexao* conexao) {
+#ifdef __linux__
+    epoll_ctl(laco_fd, EPOLL_CTL_DEL, conexao->fd, NULL);
+#else
+    // O último ocupa o lugar do removido
+    int i = conexao->indice;
+    laco_tamanho--;
+    laco_fds[i] = laco_fds[laco_tamanho];
+    laco_conexoes[i] = laco_conexoes[laco_tamanho];
+    if (laco_conexoes[i] != NULL) {
+        laco_conexoes[i]->indice = i;
+    }
+#endif
+}
+
+void fechar_conexao(Conexao* conexao) {
+    laco_remover(conexao);
+    close(conexao->fd);
+    free(conexao->entrada.dados);
+    free(conexao->saida.dados);
+    free(conexao);
+}
+
+// Função para ler um inteiro decimal de um campo; retorna 0 se não for um número
+int ler_inteiro(const char* campo, int* valor) {
+    if (campo == NULL || *campo == '\0') {
+        return 0;
+    }
+    char* fim;
+    errno = 0;
+    long numero = strtol(campo, &fim, 10);
+    if (*fim != '\0' || errno != 0 || numero < -2147483647L || numero > 2147483647L) {
+        return 0;
+    }
+    *valor = (int) numero;
+    return 1;
+}
+
+// Função para separar o próximo campo da linha (separado por espaços)
+char* proximo_campo(char** cursor) {
+    char* inicio = *cursor;
+    while (*inicio == ' ') {
+        inicio++;
+    }
+    if (*inicio == '\0') {
+        *cursor = inicio;
+        return NULL;
+    }
+    char* fim = inicio;
+    while (*fim != ' ' && *fim != '\0') {
+        fim++;
+    }
+    if (*fim == ' ') {
+        *fim++ = '\0';
+    }
+    *cursor = fim;
+    return inicio;
+}
+
+// Função para ler "<DD/MM/AAAA> <diarias>" de um pedido. Retorna 1 se o
+// período é válido, 0 se o formato é inválido e -1 se as diárias passam de
+// DIARIAS_MAX.
+int ler_periodo(char** cursor, DataCompacta* inicio, int* diarias) {
+    char* data = proximo_campo(cursor);
+    if (data == NULL || strlen(data) != 10) {
+        return 0;
+    }
+    *inicio = parse_data_compacta(data);
+    if (*inicio == DATA_INVALIDA || !ler_inteiro(proximo_campo(cursor), diarias) || *diarias < 1) {
+        return 0;
+    }
+    return *diarias <= DIARIAS_MAX ? 1 : -1;
+}
+
+void responder_inserir(MotorReservas* motor, Buffer* saida, char* cursor) {
+    Reserva nova_reserva = {0};
+    char* data;
+    if (!ler_inteiro(proximo_campo(&cursor), &nova_reserva.quarto_id)
+        || (data = proximo_campo(&cursor)) == NULL
+        || !ler_inteiro(proximo_campo(&cursor), &nova_reserva.num_diarias)
+        || !ler_inteiro(proximo_campo(&cursor), &nova_reserva.num_pessoas)) {
+        buffer_printf(saida, "ERRO formato\n");
+        return;
+    }
+    while (*cursor == ' ') {
+        cursor++;
+    }
+    if (*cursor == '\0' || strlen(cursor) >= sizeof(nova_reserva.nome_cliente)) {
+        buffer_printf(saida, "ERRO nome\n");
+        return;
+    }
+    if (strlen(data) != 10 || !verificarDataValida(data)) {
+        buffer_printf(saida, "ERRO data_invalida\n");
+        return;
+    }
+    if (nova_reserva.num_diarias < 1 || nova_reserva.num_diarias > DIARIAS_MAX || nova_reserva.num_pessoas < 1) {
+        buffer_printf(saida, "ERRO dados_invalidos\n");
+        return;
+    }
+    strcpy(nova_reserva.data_inicio, data);
+    strcpy(nova_reserva.nome_cliente, cursor);
+
+    // Conferência e inserção são uma só operação: dois pedidos simultâneos
+    // para o mesmo quarto não passam os dois
+    switch (reservarQuarto(motor, &nova_reserva)) {
+        case LOTE_OK:
+            buffer_printf(saida, "OK %d %.2f\n", nova_reserva.reserva_id, nova_reserva.preco);
+            break;
+        case LOTE_CONFLITO_EXISTENTE:
+            buffer_printf(saida, "ERRO quarto_ocupado\n");
+            break;
+        case LOTE_CAPACIDADE:
+            buffer_printf(saida, "ERRO capacidade\n");
+            break;
+        case LOTE_QUARTO_INVALIDO:
+            buffer_printf(saida, "ERRO quarto_invalido\n");
+            break;
+        case LOTE_ERRO_DIARIO:
+            buffer_printf(saida, "ERRO diario\n");
+            break;
+        default:
+            buffer_printf(saida, "ERRO dados_invalidos\n");
+    }
+}
+
+void responder_buscar(MotorReservas* motor, Buffer* saida, char* cursor) {
+    int id;
+    if (!ler_inteiro(proximo_campo(&cursor), &id)) {
+        buffer_printf(saida, "ERRO formato\n");
+        return;
+    }
+    Reserva reserva;
+    if (!buscarReserva(motor, id, &reserva)) {
+        buffer_printf(saida, "ERRO nao_encontrada\n");
+        return;
+    }
+    buffer_printf(saida, "OK %d %d %s %d %d %.2f %s\n", reserva.reserva_id, reserva.quarto_id,
+                  reserva.data_inicio, reserva.num_diarias, reserva.num_pessoas, reserva.preco,
+                  reserva.nome_cliente);
+}
+
+void responder_nome(MotorReservas* motor, Buffer* saida, char* cursor) {
+    char chave[NOME_CHAVE_MAX];
+    if (normalizar_nome(cursor, chave) == 0) {
+        buffer_printf(saida, "ERRO formato\n");
+        return;
+    }
+    int* ids;
+    int total = buscarReservasPorNome(motor, cursor, 1, &ids);
+    if (total > SERVIDOR_MAX_RESULTADOS) {
+        buffer_printf(saida, "ERRO muitos_resultados\n");
+        free(ids);
+        return;
+    }
+    buffer_printf(saida, "OK %d", total);
+    for (int i = 0; i < total; i++) {
+        buffer_printf(saida, " %d", ids[i]);
+    }
+    buffer_printf(saida, "\n");
+    free(ids);
+}
+
+void responder_rede_nome(Buffer* saida, char* cursor) {
+    char chave[NOME_CHAVE_MAX];
+    if (normalizar_nome(cursor, chave) == 0) {
+        buffer_printf(saida, "ERRO formato\n");
+        return;
+    }
+    ReservaRede* reservas;
+    int total = buscarHospedeNaRede(rede, cursor, 1, &reservas);
+    if (total > SERVIDOR_MAX_RESULTADOS) {
+        buffer_printf(saida, "ERRO muitos_resultados\n");
+        free(reservas);
+        return;
+    }
+    buffer_printf(saida, "OK %d", total);
+    for (int i = 0; i < total; i++) {
+        buffer_printf(saida, " %s:%d", codigoDoHotel(rede, reservas[i].hotel), reservas[i].reserva.reserva_id);
+    }
+    buffer_printf(saida, "\n");
+    free(reservas);
+}
+
+void responder_rede_receita(Buffer* saida, char* cursor) {
+    char* de = proximo_campo(&cursor);
+    char* ate = proximo_campo(&cursor);
+    DataCompacta inicio = DATA_INVALIDA, fim = DATA_INVALIDA;
+    if (de != NULL && ate != NULL && strlen(de) == 10 && strlen(ate) == 10) {
+        inicio = parse_data_compacta(de);
+        fim = parse_data_compacta(ate);
+    }
+    if (inicio == DATA_INVALIDA || fim == DATA_INVALIDA || fim < inicio) {
+        buffer_printf(saida, "ERRO formato\n");
+        return;
+    }
+    TotaisReservas totais = totalizarRede(rede, inicio, fim + 1, NULL);
+    buffer_printf(saida, "OK %ld %ld %.2f\n", totais.reservas, totais.diarias, totais.receita);
+}
+
+// Função para executar um pedido (uma linha sem o '\n') e escrever a resposta
+void processar_pedido(Conexao* conexao, char* linha) {
+    Buffer* saida = &conexao->saida;
+    MotorReservas* motor = motorDoHotel(rede, conexao->hotel);
+    char* cursor = linha;
+    char* comando = proximo_campo(&cursor);
+    if (comando == NULL) {
+        return; // Linha vazia
+    }
+
+    if (strcmp(comando, "INSERIR") == 0) {
+        responder_inserir(motor, saida, cursor);
+    } else if (strcmp(comando, "REMOVER") == 0) {
+        int id;
+        int removida = 0;
+        if (!ler_inteiro(proximo_campo(&cursor), &id)) {
+            buffer_printf(saida, "ERRO formato\n");
+        } else if ((removida = removerReserva(motor, id)) > 0) {
+            buffer_printf(saida, "OK\n");
+        } else if (removida < 0) {
+            buffer_printf(saida, "ERRO diario\n");
+        } else {
+            buffer_printf(saida, "ERRO nao_encontrada\n");
+        }
+    } else if (strcmp(comando, "BUSCAR") == 0) {
+        responder_buscar(motor, saida, cursor);
+    } else if (strcmp(comando, "NOME") == 0) {
+        responder_nome(motor, saida, cursor);
+    } else if (strcmp(comando, "DISPONIVEL") == 0) {
+        int quarto, diarias;
+        DataCompacta inicio;
+        int periodo = ler_inteiro(proximo_campo(&cursor), &quarto) ? ler_periodo(&cursor, &inicio, &diarias) : 0;
+        if (periodo == 0) {
+            buffer_printf(saida, "ERRO formato\n");
+        } else if (periodo < 0) {
+            buffer_printf(saida, "ERRO dados_invalidos\n");
+        } else {
+            buffer_printf(saida, "OK %d\n", isRoomAvailable(motor, quarto, inicio, diarias));
+        }
+    } else if (strcmp(comando, "PRECO") == 0) {
+        int quarto, diarias, pessoas;
+        DataCompacta inicio;
+        double preco = -1.0;
+        int periodo = ler_inteiro(proximo_campo(&cursor), &quarto) ? ler_periodo(&cursor, &inicio, &diarias) : 0;
+        if (periodo > 0 && ler_inteiro(proximo_campo(&cursor), &pessoas)) {
+            preco = calcularPreco(motor, quarto, inicio, diarias, pessoas);
+        }
+        if (periodo < 0) {
+            buffer_printf(saida, "ERRO dados_invalidos\n");
+        } else if (preco < 0.0) {
+            buffer_printf(saida, "ERRO formato\n");
+        } else {
+            buffer_printf(saida, "OK %.2f\n", preco);
+        }
+    } else if (strcmp(comando, "LIVRES") == 0) {
+        int diarias;
+        DataCompacta inicio;
+        int periodo = ler_periodo(&cursor, &inicio, &diarias);
+        if (periodo == 0) {
+            buffer_printf(saida, "ERRO formato\n");
+        } else if (periodo < 0) {
+            buffer_printf(saida, "ERRO dados_invalidos\n");
+        } else {
+            int max = contarQuartos(motor);
+            int* livres = (int*) malloc((size_t) max * sizeof(int));
+            if (livres == NULL) {
+                printf("Erro de alocação de memória!\n");
+                exit(1);
+            }
+            int total = quartosLivres(motor, inicio, diarias, livres, max);
+            buffer_printf(saida, "OK %d", total);
+            for (int i = 0; i < total && i < max; i++) {
+                buffer_printf(saida, " %d", livres[i]);
+            }
+            buffer_printf(saida, "\n");
+            free(livres);
+        }
+    } else if (strcmp(comando, "DISPUTA") == 0) {
+        EstatisticasDisputa disputa = obterEstatisticasDisputa(motor);
+        buffer_printf(saida, "OK %ld %ld %ld %ld %ld\n", disputa.tentativas, disputa.aceitas,
+                      disputa.conflitos, disputa.repeticoes, disputa.desfeitas);
+    } else if (strcmp(comando, "HOTEL") == 0) {
+        char* codigo = proximo_campo(&cursor);
+        int hotel = codigo != NULL ? buscarHotel(rede, codigo) : -1;
+        if (hotel < 0) {
+            buffer_printf(saida, "ERRO hotel_desconhecido\n");
+        } else {
+            conexao->hotel = hotel;
+            buffer_printf(saida, "OK\n");
+        }
+    } else if (strcmp(comando, "HOTEIS") == 0) {
+        buffer_printf(saida, "OK %d", contarHoteis(rede));
+        for (int i = 0; i < contarHoteis(rede); i++) {
+            buffer_printf(saida, " %s", codigoDoHotel(rede, i));
+        }
+        buffer_printf(saida, "\n");
+    } else if (strcmp(comando, "REDE_NOME") == 0) {
+        responder_rede_nome(saida, cursor);
+    } else if (strcmp(comando, "REDE_RECEITA") == 0) {
+        responder_rede_receita(saida, cursor);
+    } else if (strcmp(comando, "SAIR") == 0) {
+        conexao->fechar = 1;
+    } else {
+        buffer_printf(saida, "ERRO comando_desconhecido\n");
+    }
+}
+
+// Função para enviar o que for possível da saída pendente.
+// Retorna 0 se a conexão deve ser fechada.
+int enviar_pendente(Conexao* conexao) {
+    Buffer* saida = &conexao->saida;
+    while (conexao->enviado < saida->tamanho) {
+        ssize_t n = send(conexao->fd, saida->dados + conexao->enviado, saida->tamanho - conexao->enviado, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 1;  // Continua quando o socket aceitar escrita
+            }
+            return 0;
+        }
+        conexao->enviado += (size_t) n;
+    }
+    saida->tamanho = 0;
+    conexao->enviado = 0;
+    return !conexao->fechar;
+}
+
+// Função para executar as linhas completas recebidas, na ordem. Uma linha
+// incompleta maior que SERVIDOR_MAX_LINHA encerra a conexão com um erro; um
+// cliente que acumula mais de SERVIDOR_MAX_SAIDA em respostas sem lê-las é
+// desconectado na hora. Retorna 0 se a conexão deve ser fechada sem enviar
+// o restante.
+int executar_linhas(Conexao* conexao) {
+    Buffer* entrada = &conexao->entrada;
+    size_t inicio = 0;
+    while (!conexao->fechar) {
+        char* quebra = memchr(entrada->dados + inicio, '\n', entrada->tamanho - inicio);
+        if (quebra == NULL) {
+            break;
+        }
+        *quebra = '\0';
+        if (quebra > entrada->dados + inicio && quebra[-1] == '\r') {
+            quebra[-1] = '\0';
+        }
+        processar_pedido(conexao, entrada->dados + inicio);
+        inicio = (size_t) (quebra - entrada->dados) + 1;
+
+        if (conexao->saida.tamanho - conexao->enviado > SERVIDOR_MAX_SAIDA &&
+            (!enviar_pendente(conexao) || conexao->saida.tamanho - conexao->enviado > SERVIDOR_MAX_SAIDA)) {
+            return 0;
+        }
+    }
+    memmove(entrada->dados, entrada->dados + inicio, entrada->tamanho - inicio);
+    entrada->tamanho -= inicio;
+
+    if (entrada->tamanho > SERVIDOR_MAX_LINHA) {
+        buffer_printf(&conexao->saida, "ERRO linha_longa\n");
+        conexao->fechar = 1;
+    }
+    return 1;
+}
+
+// Função para ler o que chegou, executar as linhas completas e responder.
+// As linhas são executadas a cada leitura, então a entrada nunca passa de
+// SERVIDOR_MAX_LINHA mais uma leitura. Retorna 0 se a conexão deve ser fechada.
+int receber(Conexao* conexao) {
+    Buffer* entrada = &conexao->entrada;
+    int fim = 0;
+    while (!conexao->fechar) {
+        buffer_reservar(entrada, SERVIDOR_TAMANHO_LEITURA);
+        ssize_t n = recv(conexao->fd, entrada->dados + entrada->tamanho, SERVIDOR_TAMANHO_LEITURA, 0);
+        if (n > 0) {
+            entrada->tamanho += (size_t) n;
+            if (!executar_linhas(conexao)) {
+                return 0;
+            }
+            continue;
+        }
+        if (n == 0) {
+            fim = 1;  // O cliente encerrou o envio
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return 0;
+        }
+        break;
+    }
+    if (fim) {
+        conexao->fechar = 1;
+    }
+    return enviar_pendente(conexao);
+}
+
+void aceitar_conexoes(int escuta) {
+    for (;;) {
+        int fd = accept(escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // EAGAIN: nenhuma conexão pendente
+        }
+        if (!definir_nao_bloqueante(fd)) {
+            close(fd);
+            continue;
+        }
+        int sim = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim)); // Falha em sockets Unix, sem problema
+
+        Conexao* conexao = (Conexao*) calloc(1, sizeof(Conexao));
+        if (conexao == NULL) {
+            printf("Erro de alocação de memória!\n");
+            exit(1);
+        }
+        conexao->fd = fd;
+        laco_adicionar(fd, conexao);
+    }
+}
+
+// Função para criar o socket de escuta TCP (só em 127.0.0.1) ou Unix
+int abrir_escuta(const char* tipo, const char* endereco) {
+    int fd;
+    if (strcmp(tipo, "--tcp") == 0) {
+        int porta;
+        if (!ler_inteiro(endereco, &porta) || porta < 1 || porta > 65535) {
+            printf("Porta inválida: %s\n", endereco);
+            return -1;
+        }
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            perror("socket");
+            return -1;
+        }
+        int sim = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &sim, sizeof(sim));
+        struct sockaddr_in addr = {0};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t) porta);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0) {
+            perror("bind");
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_un addr = {0};
+        if (strlen(endereco) >= sizeof(addr.sun_path)) {
+            printf("Caminho muito longo: %s\n", endereco);
+            return -1;
+        }
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            perror("socket");
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, endereco);
+        unlink(endereco); // Socket deixado por uma execução anterior
+        if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0) {
+            perror("bind");
+            close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, SOMAXCONN) != 0 || !definir_nao_bloqueante(fd)) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void tratar_sinal(int sinal) {
+    (void) sinal;
+    encerrar = 1;
+}
+
+// Laço de atendimento, executado por cada thread. A espera acorda pelo menos
+// a cada janela do diário para sincronizá-lo.
+void* atender(void* arg) {
+    int escuta = *(const int*) arg;
+    while (!encerrar) {
+#ifdef __linux__
+        struct epoll_event eventos[SERVIDOR_MAX_EVENTOS];
+        int n = epoll_wait(laco_fd, eventos, SERVIDOR_MAX_EVENTOS, DIARIO_JANELA_MS);
+        for (int i = 0; i < n; i++) {
+            Conexao* conexao = (Conexao*) eventos[i].data.ptr;
+            uint32_t ocorridos = eventos[i].events;
+#else
+        int n = poll(laco_fds, (nfds_t) laco_tamanho, DIARIO_JANELA_MS);
+        // Percorre de trás para frente: fechar uma conexão move a última para o seu lugar
+        for (int i = laco_tamanho - 1; n > 0 && i >= 0; i--) {
+            if (laco_fds[i].revents == 0) {
+                continue;
+            }
+            Conexao* conexao = laco_conexoes[i];
+            int ocorridos = laco_fds[i].revents;
+            laco_fds[i].revents = 0;
+#endif
+            if (conexao == NULL) {
+                aceitar_conexoes(escuta);
+                laco_rearmar(escuta, NULL, 0);
+                continue;
+            }
+            int aberta = 1;
+            if (ocorridos & (EVENTO_LEITURA | EVENTO_FIM)) {
+                aberta = receber(conexao);
+            } else if (ocorridos & EVENTO_ESCRITA) {
+                aberta = enviar_pendente(conexao);
+            }
+            // Depois de rearmada, a conexão pode ser atendida por outra thread
+            if (!aberta) {
+                fechar_conexao(conexao);
+            } else {
+                laco_rearmar(conexao->fd, conexao, conexao->enviado < conexao->saida.tamanho);
+            }
+        }
+        for (int i = 0; i < contarHoteis(rede); i++) {
+            diario_sincronizar(motorDoHotel(rede, i));
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    int uso_valido = argc >= 3 && argc % 2 == 1
+                     && (strcmp(argv[1], "--tcp") == 0 || strcmp(argv[1], "--unix") == 0);
+    const char* opcao_threads = NULL;
+    const char* arquivo_hoteis = NULL;
+    for (int i = 3; uso_valido && i < argc; i += 2) {
+        if (strcmp(argv[i], "--threads") == 0 && opcao_threads == NULL) {
+            opcao_threads = argv[i + 1];
+        } else if (strcmp(argv[i], "--hoteis") == 0 && arquivo_hoteis == NULL) {
+            arquivo_hoteis = argv[i + 1];
+        } else {
+            uso_valido = 0;
+        }
+    }
+    if (!uso_valido) {
+        printf("Uso: %s --tcp PORTA | --unix CAMINHO [--threads N] [--hoteis ARQUIVO]\n", argv[0]);
+        return 1;
+    }
+
+    int threads = 1;
+#ifdef __linux__
+    threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (opcao_threads != NULL && (!ler_inteiro(opcao_threads, &threads) || threads < 1)) {
+        printf("Número de threads inválido: %s\n", opcao_threads);
+        return 1;
+    }
+#ifdef __linux__
+    if (threads < 1) {
+        threads = 1;
+    } else if (threads > SERVIDOR_MAX_THREADS) {
+        threads = SERVIDOR_MAX_THREADS;
+    }
+#else
+    threads = 1; // O laço com poll não é compartilhado entre threads
+#endif
+
+    // Cada hotel tem o seu layout, tarifas, snapshot e diário. Sem --hoteis,
+    // os mesmos arquivos da interface gráfica, na pasta atual.
+    rede = criarRedeHoteis(0);
+    if (arquivo_hoteis != NULL) {
+        int abertos = carregarRede(rede, arquivo_hoteis);
+        if (abertos <= 0) {
+            if (abertos == 0) {
+                printf("O arquivo %s não existe ou não tem hotéis.\n", arquivo_hoteis);
+            }
+            return 1;
+        }
+    } else if (abrirHotel(rede, "principal", ".") < 0) {
+        return 1;
+    }
+
+    int escuta = abrir_escuta(argv[1], argv[2]);
+    if (escuta < 0) {
+        return 1;
+    }
+
+    struct sigaction acao = {0};
+    acao.sa_handler = tratar_sinal;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+#ifdef __linux__
+    laco_fd = epoll_create1(0);
+    if (laco_fd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+#endif
+    laco_adicionar(escuta, NULL);
+    long reservas = 0;
+    for (int i = 0; i < contarHoteis(rede); i++) {
+        reservas += contarReservas(motorDoHotel(rede, i));
+    }
+    printf("Servidor de reservas em %s %s (%d hotel(is), %ld reservas, %d thread(s))\n", argv[1], argv[2],
+           contarHoteis(rede), reservas, threads);
+    fflush(stdout);
+
+    // A thread principal é uma das que atendem
+#ifdef __linux__
+    pthread_t ajudantes[SERVIDOR_MAX_THREADS];
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&ajudantes[i], NULL, atender, &escuta) != 0) {
+            printf("Não foi possível criar as threads.\n");
+            return 1;
+        }
+    }
+#endif
+    atender(&escuta);
+#ifdef __linux__
+    for (int i = 1; i < threads; i++) {
+        pthread_join(ajudantes[i], NULL);
+    }
+#endif
+
+    printf("Encerrando...\n");
+    close(escuta);
+    if (strcmp(argv[1], "--unix") == 0) {
+        unlink(argv[2]);
+    }
+    for (int i = 0; i < contarHoteis(rede); i++) {
+        diario_compactar(motorDoHotel(rede, i));
+    }
+    liberarRedeHoteis(rede);
+    return 0;
+}
@@ -0,0 +1,274 @@
+// teste_diario.c
+// Testes do diário (write-ahead log) do motor de reservas:
+//  - inserções, remoções e lotes gravados no diário são reproduzidos num
+//    motor novo com os mesmos ids, preços e dados;
+//  - uma entrada final incompleta (queda durante a escrita) é descartada e
+//    as anteriores continuam valendo;
+//  - um lote cortado no meio não é aplicado, nem em parte;
+//  - uma escrita que falha (arquivo no limite de tamanho) recusa a operação,
+//    não altera as reservas e não deixa bytes parciais que esconderiam as
+//    entradas seguintes na reprodução (só em sistemas POSIX).
+//
+// Uso: teste_diario (ou 'make teste'). Retorna 0 se todos os testes passarem.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/resource.h>
+#endif
+#include "motor_reservas.h"
+
+#define ARQUIVO_TESTE_RESERVAS "teste_diario.dat"
+#define ARQUIVO_TESTE_DIARIO "teste_diario.wal"
+
+static int falhas = 0;
+
+// Função para registrar uma falha
+static void falhar(const char* descricao) {
+    printf("FALHOU: %s\n", descricao);
+    falhas++;
+}
+
+// Função para obter o tamanho de um arquivo, ou -1 se ele não existe
+static long tamanho_arquivo(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    fclose(arquivo);
+    return tamanho;
+}
+
+// Função para cortar um arquivo em 'tamanho' bytes, como numa queda no meio
+// de uma escrita
+static void cortar_arquivo(const char* caminho, long tamanho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    char* dados = (char*) malloc((size_t) tamanho + 1);
+    if (arquivo == NULL || dados == NULL || fread(dados, 1, (size_t) tamanho, arquivo) != (size_t) tamanho) {
+        printf("Erro ao ler %s\n", caminho);
+        exit(1);
+    }
+    fclose(arquivo);
+    arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL || fwrite(dados, 1, (size_t) tamanho, arquivo) != (size_t) tamanho) {
+        printf("Erro ao gravar %s\n", caminho);
+        exit(1);
+    }
+    fclose(arquivo);
+    free(dados);
+}
+
+// Função para criar um motor com o snapshot e o diário de teste, como os
+// programas fazem ao iniciar
+static MotorReservas* abrir_motor() {
+    MotorReservas* motor = criarMotorReservas();
+    if (carregarReservas(motor, ARQUIVO_TESTE_RESERVAS) < 0 || diario_reproduzir(motor, ARQUIVO_TESTE_DIARIO) < 0 ||
+        !diario_abrir(motor, ARQUIVO_TESTE_DIARIO, ARQUIVO_TESTE_RESERVAS, 0)) {
+        printf("Erro ao abrir o motor de teste\n");
+        exit(1);
+    }
+    return motor;
+}
+
+// Função para reabrir os arquivos num motor novo e conferir que ele tem
+// exatamente as reservas de 'esperado'
+static void conferir_reproducao(MotorReservas* esperado, const char* descricao) {
+    MotorReservas* reaberto = abrir_motor();
+    int iguais = contarReservas(reaberto) == contarReservas(esperado);
+    for (No* no = primeiroNo(esperado); iguais && no != NULL; no = proximoNo(no)) {
+        const Reserva* reserva = reservaDoNo(no);
+        Reserva lida;
+        iguais = buscarReserva(reaberto, reserva->reserva_id, &lida) && lida.quarto_id == reserva->quarto_id &&
+                 strcmp(lida.data_inicio, reserva->data_inicio) == 0 && lida.num_diarias == reserva->num_diarias &&
+                 lida.num_pessoas == reserva->num_pessoas && fabs(lida.preco - reserva->preco) < 0.005 &&
+                 strcmp(lida.nome_cliente, reserva->nome_cliente) == 0;
+    }
+    if (!iguais) {
+        falhar(descricao);
+    }
+    liberarMotorReservas(reaberto);
+}
+
+// Função para preencher uma reserva de teste
+static Reserva nova_reserva(int quarto, const char* data, int diarias, int pessoas, const char* nome) {
+    Reserva reserva;
+    memset(&reserva, 0, sizeof(reserva));
+    reserva.quarto_id = quarto;
+    snprintf(reserva.data_inicio, sizeof(reserva.data_inicio), "%s", data);
+    reserva.num_diarias = diarias;
+    reserva.num_pessoas = pessoas;
+    snprintf(reserva.nome_cliente, sizeof(reserva.nome_cliente), "%s", nome);
+    return reserva;
+}
+
+// Função para apagar os arquivos de teste
+static void apagar_arquivos() {
+    remove(ARQUIVO_TESTE_RESERVAS);
+    remove(ARQUIVO_TESTE_DIARIO);
+}
+
+// Reproduz inserções, remoções e lotes; retorna o tamanho de uma entrada
+static long testar_reproducao() {
+    apagar_arquivos();
+    MotorReservas* motor = abrir_motor();
+
+    Reserva r1 = nova_reserva(1, "10/03/2030", 3, 2, "Alice Santos");
+    Reserva r2 = nova_reserva(2, "11/03/2030", 2, 1, "Bruno Lima");
+    if (reservarQuarto(motor, &r1) != LOTE_OK) {
+        falhar("reserva 1 recusada");
+    }
+    long antes = tamanho_arquivo(ARQUIVO_TESTE_DIARIO);
+    if (reservarQuarto(motor, &r2) != LOTE_OK) {
+        falhar("reserva 2 recusada");
+    }
+    long entrada = tamanho_arquivo(ARQUIVO_TESTE_DIARIO) - antes;
+
+    Reserva lote[3] = {
+        nova_reserva(3, "01/04/2030", 1, 2, "Carla Oliveira"),
+        nova_reserva(4, "02/04/2030", 4, 3, "Daniel Costa"),
+        nova_reserva(5, "01/04/2030", 2, 1, "Eliana Martins"),
+    };
+    if (!inserirReservasLote(motor, lote, 3, NULL)) {
+        falhar("lote recusado");
+    }
+    if (removerReserva(motor, r1.reserva_id) != 1) {
+        falhar("remoção da reserva 1");
+    }
+    if (tamanho_arquivo(ARQUIVO_TESTE_DIARIO) != antes + entrada * 6) {
+        falhar("diário sem uma entrada por operação e por reserva do lote");
+    }
+    conferir_reproducao(motor, "reprodução de inserções, lote e remoção");
+    liberarMotorReservas(motor);
+    return entrada;
+}
+
+// Uma entrada final incompleta é descartada; as anteriores continuam
+static void testar_final_incompleto(long entrada) {
+    apagar_arquivos();
+    MotorReservas* motor = abrir_motor();
+    Reserva r1 = nova_reserva(1, "10/03/2030", 3, 2, "Alice Santos");
+    Reserva r2 = nova_reserva(2, "11/03/2030", 2, 1, "Bruno Lima");
+    reservarQuarto(motor, &r1);
+    long integro = tamanho_arquivo(ARQUIVO_TESTE_DIARIO);
+    reservarQuarto(motor, &r2);
+    liberarMotorReservas(motor);
+
+    cortar_arquivo(ARQUIVO_TESTE_DIARIO, integro + entrada / 2);
+    motor = abrir_motor();
+    Reserva lida;
+    if (contarReservas(motor) != 1 || !buscarReserva(motor, r1.reserva_id, &lida)) {
+        falhar("entrada incompleta no fim do diário");
+    }
+    if (tamanho_arquivo(ARQUIVO_TESTE_DIARIO) != integro) {
+        falhar("entrada incompleta não foi removida do diário");
+    }
+
+    // Operações novas entram depois da última entrada íntegra
+    Reserva r3 = nova_reserva(3, "12/03/2030", 1, 1, "Carla Oliveira");
+    if (reservarQuarto(motor, &r3) != LOTE_OK) {
+        falhar("reserva depois da reprodução recusada");
+    }
+    conferir_reproducao(motor, "reserva depois de descartar a entrada incompleta");
+    liberarMotorReservas(motor);
+}
+
+// Um lote cortado no meio não é aplicado
+static void testar_lote_incompleto(long entrada) {
+    apagar_arquivos();
+    MotorReservas* motor = abrir_motor();
+    Reserva r1 = nova_reserva(1, "10/03/2030", 3, 2, "Alice Santos");
+    reservarQuarto(motor, &r1);
+    long integro = tamanho_arquivo(ARQUIVO_TESTE_DIARIO);
+    Reserva lote[3] = {
+        nova_reserva(3, "01/04/2030", 1, 2, "Carla Oliveira"),
+        nova_reserva(4, "02/04/2030", 4, 3, "Daniel Costa"),
+        nova_reserva(5, "01/04/2030", 2, 1, "Eliana Martins"),
+    };
+    inserirReservasLote(motor, lote, 3, NULL);
+    liberarMotorReservas(motor);
+
+    // Cabeçalho do lote, duas inserções inteiras e metade da terceira
+    cortar_arquivo(ARQUIVO_TESTE_DIARIO, integro + entrada * 3 + entrada / 2);
+    motor = abrir_motor();
+    if (contarReservas(motor) != 1) {
+        falhar("lote incompleto aplicado em parte");
+    }
+    if (tamanho_arquivo(ARQUIVO_TESTE_DIARIO) != integro) {
+        falhar("lote incompleto não foi removido do diário");
+    }
+    liberarMotorReservas(motor);
+}
+
+// Uma escrita que falha recusa a operação e não deixa bytes parciais
+static void testar_falha_escrita(long entrada) {
+#ifdef _WIN32
+    (void) entrada;
+#else
+    apagar_arquivos();
+    MotorReservas* motor = abrir_motor();
+    Reserva r1 = nova_reserva(1, "10/03/2030", 3, 2, "Alice Santos");
+    reservarQuarto(motor, &r1);
+    long integro = tamanho_arquivo(ARQUIVO_TESTE_DIARIO);
+
+    // Limite de tamanho no meio da próxima entrada: a escrita fica parcial
+    struct rlimit original;
+    getrlimit(RLIMIT_FSIZE, &original);
+    struct rlimit limite = original;
+    limite.rlim_cur = (rlim_t) (integro + entrada / 2);
+    signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limite);
+
+    Reserva r2 = nova_reserva(2, "11/03/2030", 2, 1, "Bruno Lima");
+    if (reservarQuarto(motor, &r2) != LOTE_ERRO_DIARIO) {
+        falhar("reserva aceita sem ser gravada no diário");
+    }
+    if (removerReserva(motor, r1.reserva_id) != -1) {
+        falhar("remoção aceita sem ser gravada no diário");
+    }
+    Reserva lote[2] = {
+        nova_reserva(3, "01/04/2030", 1, 2, "Carla Oliveira"),
+        nova_reserva(4, "02/04/2030", 4, 3, "Daniel Costa"),
+    };
+    int situacao[2];
+    if (inserirReservasLote(motor, lote, 2, situacao) || situacao[0] != LOTE_ERRO_DIARIO) {
+        falhar("lote aceito sem ser gravado no diário");
+    }
+    Reserva lida;
+    if (contarReservas(motor) != 1 || !buscarReserva(motor, r1.reserva_id, &lida)) {
+        falhar("operação recusada alterou as reservas");
+    }
+    if (tamanho_arquivo(ARQUIVO_TESTE_DIARIO) != integro) {
+        falhar("escrita parcial ficou no diário");
+    }
+
+    // Sem o limite, o mesmo quarto e período voltam a ser aceitos e tudo é
+    // reproduzido
+    setrlimit(RLIMIT_FSIZE, &original);
+    if (reservarQuarto(motor, &r2) != LOTE_OK) {
+        falhar("quarto da reserva recusada continuou ocupado");
+    }
+    if (!inserirReservasLote(motor, lote, 2, NULL)) {
+        falhar("lote recusado depois da falha");
+    }
+    conferir_reproducao(motor, "reprodução depois de uma escrita com falha");
+    liberarMotorReservas(motor);
+#endif
+}
+
+int main() {
+    long entrada = testar_reproducao();
+    testar_final_incompleto(entrada);
+    testar_lote_incompleto(entrada);
+    testar_falha_escrita(entrada);
+    apagar_arquivos();
+    if (falhas > 0) {
+        printf("%d teste(s) falharam\n", falhas);
+        return 1;
+    }
+    printf("Todos os testes do diário passaram\n");
+    return 0;
+}
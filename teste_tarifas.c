@@ -0,0 +1,243 @@
+// teste_tarifas.c
+// Testes das tarifas do motor de reservas:
+//  - carregarTarifas recusa arquivos com linhas malformadas, sem aplicar
+//    nenhuma regra, e aceita linhas em branco e comentários;
+//  - calcularPreco, que soma as diárias em O(1), confere com uma soma dia a
+//    dia feita aqui, depois de uma sequência aleatória de alterações de
+//    tarifa base, fatores da semana e temporadas;
+//  - a reserva incluída guarda o mesmo preço de calcularPreco.
+//
+// Uso: teste_tarifas (ou 'make teste'). Retorna 0 se todos os testes passarem.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "motor_reservas.h"
+
+#define ARQUIVO_TESTE "teste_tarifas.tmp"
+#define QUARTOS_TESTE 50
+#define DIA_INICIAL 20000    // 04/10/2024
+#define DIAS_TABELA 6000     // Dias cobertos pelas temporadas do teste
+#define ALTERACOES 3000
+
+// Tarifas esperadas, mantidas aqui em paralelo ao motor
+static double base_esperada[TIPOS_QUARTO_MAX];
+static double fator_esperado[TIPOS_QUARTO_MAX][7];
+static double temporada_esperada[TIPOS_QUARTO_MAX][DIAS_TABELA];  // 0 = sem temporada
+static int tipo_do_quarto[QUARTOS_TESTE * 7 + 1];
+
+static int falhas = 0;
+
+// Função para registrar uma falha
+static void falhar(const char* descricao) {
+    printf("FALHOU: %s\n", descricao);
+    falhas++;
+}
+
+// Função para gravar o conteúdo de um arquivo de tarifas de teste
+static void gravar_arquivo(const char* conteudo) {
+    FILE* arquivo = fopen(ARQUIVO_TESTE, "w");
+    if (arquivo == NULL) {
+        printf("Erro ao criar %s\n", ARQUIVO_TESTE);
+        exit(1);
+    }
+    fputs(conteudo, arquivo);
+    fclose(arquivo);
+}
+
+// Dia da semana de uma data compacta (0 = domingo); 01/01/1970 foi quinta
+static int dia_da_semana(long dia) {
+    int resto = (int) ((dia + 4) % 7);
+    return resto < 0 ? resto + 7 : resto;
+}
+
+// Função para calcular o preço somando dia a dia
+static double preco_esperado(int quarto, DataCompacta inicio, int dias, int pessoas) {
+    int tipo = tipo_do_quarto[quarto];
+    double soma = 0.0;
+    for (long dia = inicio; dia < (long) inicio + dias; dia++) {
+        double tarifa = base_esperada[tipo];
+        if (dia >= DIA_INICIAL && dia < DIA_INICIAL + DIAS_TABELA && temporada_esperada[tipo][dia - DIA_INICIAL] > 0.0) {
+            tarifa = temporada_esperada[tipo][dia - DIA_INICIAL];
+        }
+        soma += tarifa * fator_esperado[tipo][dia_da_semana(dia)];
+    }
+    return soma * pessoas;
+}
+
+// Função para conferir que uma linha sozinha torna o arquivo inválido e que
+// nada dele é aplicado
+static void testar_linha_invalida(MotorReservas* motor, const char* linha) {
+    char conteudo[256];
+    snprintf(conteudo, sizeof(conteudo), "base 0 300\n%s\n", linha);
+    gravar_arquivo(conteudo);
+    double antes = calcularPreco(motor, 1, DIA_INICIAL, 1, 1);
+    if (carregarTarifas(motor, ARQUIVO_TESTE) != -1) {
+        char descricao[256];
+        snprintf(descricao, sizeof(descricao), "linha aceita: \"%s\"", linha);
+        falhar(descricao);
+    }
+    if (calcularPreco(motor, 1, DIA_INICIAL, 1, 1) != antes) {
+        falhar("arquivo inválido alterou as tarifas");
+    }
+}
+
+// Função para testar a leitura do arquivo de tarifas
+static void testar_arquivos() {
+    MotorReservas* motor = criarMotorReservas();
+
+    static const char* linhas_invalidas[] = {
+        "base",                                     // sem tipo
+        "base x 400",                               // tipo não numérico
+        "semana",
+        "temporada",
+        "base 1",                                   // sem tarifa
+        "base 1 0",
+        "base 1 -10",
+        "base 1 400 500",                           // campo a mais
+        "base 16 400",                              // tipo fora do limite
+        "base -1 400",
+        "semana 0 1 1 1",                           // faltam fatores
+        "semana 0 1 1 1 1 1 1 0",
+        "semana 0 1 1 1 1 1 1 1 1",
+        "temporada 1 20/12/2030 600",               // falta o fim
+        "temporada 1 31/02/2030 05/01/2031 600",    // data inexistente
+        "temporada 1 5/1/2031 10/01/2031 600",      // data sem zeros
+        "temporada 1 05/01/2031 20/12/2030 600",    // fim antes do início
+        "temporada 1 01/01/2030 01/01/2045 600",    // período longo demais
+        "temporada 1 20/12/2030 05/01/2031 -1",
+        "desconto 1 10",                            // regra desconhecida
+    };
+    int quantidade = (int) (sizeof(linhas_invalidas) / sizeof(linhas_invalidas[0]));
+    for (int i = 0; i < quantidade; i++) {
+        testar_linha_invalida(motor, linhas_invalidas[i]);
+    }
+
+    // Arquivo só com linhas em branco e comentários: nenhuma regra
+    gravar_arquivo("\n   \n# comentário\n\t# outro\n");
+    if (carregarTarifas(motor, ARQUIVO_TESTE) != 0) {
+        falhar("arquivo sem regras não retornou 0");
+    }
+
+    // Arquivo válido: regras aplicadas, comentários no fim da linha ignorados
+    gravar_arquivo("# Tarifas de teste\n"
+                   "base 0 400   # quarto padrão\n"
+                   "semana 0 1 1 1 1 1 1.5 1.5\n"
+                   "temporada 0 20/12/2030 05/01/2031 600\n");
+    if (carregarTarifas(motor, ARQUIVO_TESTE) != 3) {
+        falhar("arquivo válido não aplicou 3 regras");
+    }
+    // 02/12/2030 é segunda: 4 dias úteis a 400, mais sexta a 400 * 1.5
+    DataCompacta segunda = parse_data_compacta("02/12/2030");
+    if (fabs(calcularPreco(motor, 1, segunda, 5, 2) - (4 * 400.0 + 600.0) * 2) > 1e-9) {
+        falhar("preço do arquivo válido");
+    }
+    // 23/12/2030 é segunda, dentro da temporada
+    if (fabs(calcularPreco(motor, 1, parse_data_compacta("23/12/2030"), 1, 1) - 600.0) > 1e-9) {
+        falhar("preço da temporada do arquivo válido");
+    }
+
+    remove(ARQUIVO_TESTE);
+    liberarMotorReservas(motor);
+}
+
+// Função para comparar calcularPreco com a soma dia a dia depois de
+// alterações aleatórias das tarifas
+static void testar_precos() {
+    MotorReservas* motor = criarMotorReservas();
+    srand(5);
+    for (int tipo = 0; tipo < TIPOS_QUARTO_MAX; tipo++) {
+        base_esperada[tipo] = PRECO_RESERVA;
+        for (int dia = 0; dia < 7; dia++) {
+            fator_esperado[tipo][dia] = 1.0;
+        }
+    }
+
+    // Quartos 1, 8, 15, ... com um de 4 tipos cada
+    Quarto quartos[QUARTOS_TESTE];
+    for (int i = 0; i < QUARTOS_TESTE; i++) {
+        quartos[i].numero = 1 + i * 7;
+        quartos[i].andar = 0;
+        quartos[i].tipo = rand() % 4;
+        quartos[i].capacidade = 3;
+        tipo_do_quarto[quartos[i].numero] = quartos[i].tipo;
+    }
+    definirQuartos(motor, quartos, QUARTOS_TESTE, 0);
+    if (calcularPreco(motor, 2, DIA_INICIAL, 1, 1) >= 0.0) {
+        falhar("preço de quarto inexistente");
+    }
+
+    int erros_preco = 0;
+    for (int k = 0; k < ALTERACOES; k++) {
+        int tipo = rand() % 4;
+        switch (rand() % 4) {
+            case 1: {
+                double tarifa = 100 + rand() % 300;
+                definirTarifaBase(motor, tipo, tarifa);
+                base_esperada[tipo] = tarifa;
+                break;
+            }
+            case 2: {
+                int dia = rand() % 7;
+                double fator = 0.5 + (rand() % 10) / 10.0;
+                definirFatorSemana(motor, tipo, dia, fator);
+                fator_esperado[tipo][dia] = fator;
+                break;
+            }
+            case 3: {
+                int inicio = DIA_INICIAL + rand() % (DIAS_TABELA - 400);
+                int dias = 1 + rand() % 365;
+                double tarifa = (rand() % 4 == 0) ? 0.0 : 50 + rand() % 500;
+                definirTarifaTemporada(motor, tipo, inicio, dias, tarifa);
+                for (int i = 0; i < dias; i++) {
+                    temporada_esperada[tipo][inicio - DIA_INICIAL + i] = tarifa;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        // Períodos também antes e depois da faixa das temporadas
+        int quarto = 1 + 7 * (rand() % QUARTOS_TESTE);
+        DataCompacta inicio = DIA_INICIAL - 500 + rand() % (DIAS_TABELA + 1000);
+        int dias = 1 + rand() % 400;
+        int pessoas = 1 + rand() % 3;
+        double obtido = calcularPreco(motor, quarto, inicio, dias, pessoas);
+        double esperado = preco_esperado(quarto, inicio, dias, pessoas);
+        if (fabs(obtido - esperado) > 0.01 + 1e-6 * esperado) {
+            if (erros_preco++ < 10) {
+                printf("quarto %d, dia %d, %d diárias: %.2f, esperado %.2f\n", quarto, inicio, dias, obtido,
+                       esperado);
+            }
+        }
+    }
+    if (erros_preco > 0) {
+        falhar("calcularPreco diferente da soma dia a dia");
+    }
+
+    // A reserva guarda o preço calculado na inclusão
+    Reserva reserva = {0};
+    reserva.quarto_id = 8;
+    reserva.num_diarias = 5;
+    reserva.num_pessoas = 2;
+    strcpy(reserva.nome_cliente, "Teste");
+    formatar_data_compacta(DIA_INICIAL + 100, reserva.data_inicio);
+    double esperado = calcularPreco(motor, 8, DIA_INICIAL + 100, 5, 2);
+    if (reservarQuarto(motor, &reserva) != LOTE_OK || fabs(reserva.preco - esperado) > 0.01) {
+        falhar("preço da reserva incluída");
+    }
+
+    liberarMotorReservas(motor);
+}
+
+int main() {
+    testar_arquivos();
+    testar_precos();
+    if (falhas > 0) {
+        printf("%d teste(s) falharam\n", falhas);
+        return 1;
+    }
+    printf("Todos os testes de tarifas passaram\n");
+    return 0;
+}